@@ -0,0 +1,210 @@
+/**
+ * @file ArgMax.h
+ * @brief Поиск индекса максимума в массиве size_t (ядро выбора жертвы в оптимальном кэше)
+ * @details Скалярная версия, SSE4.2 и AVX2 с выбором реализации во время выполнения.
+ * Все версии возвращают первый индекс максимального значения
+ */
+
+#ifndef ARGMAX_H
+#define ARGMAX_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ARGMAX_X86 1
+#include <immintrin.h>
+#endif
+
+namespace simd
+{
+    using ArgMaxFunc = size_t (*)(const size_t* data, size_t n);
+
+    /**
+     * @brief Скалярный поиск максимума
+     * @param data Массив значений
+     * @param n Длина массива > 0
+     * @return Индекс первого максимального элемента
+     */
+    inline size_t argmaxScalar(const size_t* data, size_t n)
+    {
+        size_t best = 0;
+        for (size_t i = 1; i < n; i++)
+        {
+            if (data[i] > data[best])
+            {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+#ifdef ARGMAX_X86
+    static_assert(sizeof(size_t) == sizeof(uint64_t), "Vector kernels assume 64-bit size_t");
+
+    /**
+     * @brief Поиск максимума на SSE4.2 (по 2 элемента)
+     * @details Беззнаковое сравнение 64-битных чисел сводится к знаковому сдвигом на 2^63
+     */
+    __attribute__((target("sse4.2")))
+    inline size_t argmaxSSE42(const size_t* data, size_t n)
+    {
+        if (n < 4)
+        {
+            return argmaxScalar(data, n);
+        }
+
+        const __m128i bias = _mm_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+        const __m128i step = _mm_set1_epi64x(2);
+
+        __m128i best_val = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), bias);
+        __m128i best_idx = _mm_set_epi64x(1, 0);
+        __m128i cur_idx = _mm_add_epi64(best_idx, step);
+
+        size_t i = 2;
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128i val = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), bias);
+            __m128i greater = _mm_cmpgt_epi64(val, best_val);
+            best_val = _mm_blendv_epi8(best_val, val, greater);
+            best_idx = _mm_blendv_epi8(best_idx, cur_idx, greater);
+            cur_idx = _mm_add_epi64(cur_idx, step);
+        }
+
+        alignas(16) uint64_t vals[2];
+        alignas(16) uint64_t idxs[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(vals), _mm_xor_si128(best_val, bias));
+        _mm_store_si128(reinterpret_cast<__m128i*>(idxs), best_idx);
+
+        size_t best = idxs[0];
+        if (vals[1] > vals[0] || (vals[1] == vals[0] && idxs[1] < idxs[0]))
+        {
+            best = idxs[1];
+        }
+
+        for (; i < n; i++)
+        {
+            if (data[i] > data[best])
+            {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Поиск максимума на AVX2 (по 8 элементов в двух независимых аккумуляторах)
+     */
+    __attribute__((target("avx2")))
+    inline size_t argmaxAVX2(const size_t* data, size_t n)
+    {
+        if (n < 16)
+        {
+            return argmaxScalar(data, n);
+        }
+
+        const __m256i bias = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+        const __m256i step = _mm256_set1_epi64x(8);
+
+        __m256i best_val_a = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), bias);
+        __m256i best_val_b = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 4)), bias);
+        __m256i best_idx_a = _mm256_set_epi64x(3, 2, 1, 0);
+        __m256i best_idx_b = _mm256_set_epi64x(7, 6, 5, 4);
+        __m256i cur_idx_a = _mm256_add_epi64(best_idx_a, step);
+        __m256i cur_idx_b = _mm256_add_epi64(best_idx_b, step);
+
+        size_t i = 8;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i val_a = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), bias);
+            __m256i val_b = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 4)), bias);
+            __m256i greater_a = _mm256_cmpgt_epi64(val_a, best_val_a);
+            __m256i greater_b = _mm256_cmpgt_epi64(val_b, best_val_b);
+            best_val_a = _mm256_blendv_epi8(best_val_a, val_a, greater_a);
+            best_val_b = _mm256_blendv_epi8(best_val_b, val_b, greater_b);
+            best_idx_a = _mm256_blendv_epi8(best_idx_a, cur_idx_a, greater_a);
+            best_idx_b = _mm256_blendv_epi8(best_idx_b, cur_idx_b, greater_b);
+            cur_idx_a = _mm256_add_epi64(cur_idx_a, step);
+            cur_idx_b = _mm256_add_epi64(cur_idx_b, step);
+        }
+
+        alignas(32) uint64_t vals[8];
+        alignas(32) uint64_t idxs[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(vals), _mm256_xor_si256(best_val_a, bias));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(vals + 4), _mm256_xor_si256(best_val_b, bias));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(idxs), best_idx_a);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(idxs + 4), best_idx_b);
+
+        size_t best = idxs[0];
+        size_t best_value = vals[0];
+        for (int lane = 1; lane < 8; lane++)
+        {
+            if (vals[lane] > best_value || (vals[lane] == best_value && idxs[lane] < best))
+            {
+                best = idxs[lane];
+                best_value = vals[lane];
+            }
+        }
+
+        for (; i < n; i++)
+        {
+            if (data[i] > data[best])
+            {
+                best = i;
+            }
+        }
+        return best;
+    }
+#endif
+
+    /**
+     * @brief Выбрать лучшую реализацию для текущего процессора
+     */
+    inline ArgMaxFunc selectArgMax()
+    {
+#ifdef ARGMAX_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return argmaxAVX2;
+        }
+        if (__builtin_cpu_supports("sse4.2"))
+        {
+            return argmaxSSE42;
+        }
+#endif
+        return argmaxScalar;
+    }
+
+    /**
+     * @brief Имя выбранной реализации (для отчетов бенчмарка)
+     */
+    inline const char* argmaxImplementationName()
+    {
+        ArgMaxFunc func = selectArgMax();
+#ifdef ARGMAX_X86
+        if (func == argmaxAVX2)
+        {
+            return "avx2";
+        }
+        if (func == argmaxSSE42)
+        {
+            return "sse4.2";
+        }
+#endif
+        return func == argmaxScalar ? "scalar" : "unknown";
+    }
+
+    /**
+     * @brief Индекс первого максимума с выбором реализации при первом вызове
+     * @param data Массив значений
+     * @param n Длина массива > 0
+     */
+    inline size_t argmax(const size_t* data, size_t n)
+    {
+        static const ArgMaxFunc func = selectArgMax();
+        return func(data, n);
+    }
+}
+
+#endif // ARGMAX_H
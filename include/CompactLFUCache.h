@@ -0,0 +1,151 @@
+/**
+ * @file CompactLFUCache.h
+ * @brief LFU кэш с плотным хранением: массив узлов с 32-битными связями и открытая адресация
+ */
+
+#ifndef COMPACTLFUCACHE_H
+#define COMPACTLFUCACHE_H
+
+#include <array>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <stdexcept>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+#include "global.h"
+#include "exceptions/CacheOperationException.h"
+
+namespace lfu
+{
+    /**
+     * @brief LFU кэш для большого числа мелких элементов
+     *
+     * @details Узлы лежат в одном массиве и связаны в кольцевые списки частот 32-битными индексами,
+     * ключ и значение хранятся в узле. Частота - насыщающийся 8-битный счетчик: элементы с частотой
+     * kMaxFrequency и выше делят один список и между собой вытесняются как в LRU. До насыщения порядок
+     * вытеснения совпадает с LFUCache. Таблица ключей - открытая адресация с линейным пробированием
+     * по индексам узлов (заполнение не выше 1/2, удаление без надгробий). Освобожденные узлы
+     * переиспользуются через список свободных
+     *
+     * @tparam K Тип ключа
+     * @tparam V Тип значения
+     * @tparam Hash Хеш ключа (результат дополнительно перемешивается)
+     */
+    template<typename K, typename V, typename Hash = std::hash<K>>
+    class CompactLFUCache
+    {
+    public:
+        using Index = uint32_t;
+
+        static constexpr Index kNone = std::numeric_limits<Index>::max();
+        static constexpr int kMaxFrequency = 255;
+
+    private:
+        /**
+         * @brief Узел: ключ, значение, связи в списке частоты и сама частота
+         */
+        struct Node
+        {
+            K key;
+            V value;
+            Index prev;
+            Index next;
+            uint8_t frequency;
+        };
+
+        using SlowGetFunc = std::function<V(const K&)>;
+
+        size_t capacity_;
+        SlowGetFunc slow_get_func_;
+
+        std::vector<Node> nodes_;
+        Index free_head_;
+        size_t size_;
+        int min_frequency_;
+
+        /**
+         * @brief Голова кольцевого списка каждой частоты (хвост - prev головы), kNone если список пуст
+         */
+        std::array<Index, kMaxFrequency + 1> heads_;
+
+        /**
+         * @brief Таблица ключей: индекс узла + 1, 0 - пустая ячейка
+         */
+        std::vector<Index> slots_;
+        size_t slot_mask_;
+        Hash hash_;
+
+        size_t slotOf(const K& key) const;
+
+        /**
+         * @brief Ячейка таблицы с ключом или первая пустая ячейка его цепочки
+         */
+        size_t probe(const K& key) const;
+
+        void eraseSlot(size_t slot);
+        void link(Index node, int frequency);
+        void unlink(Index node);
+        void touch(Index node);
+        Index allocateNode(const K& key, V value);
+
+    public:
+        /**
+         * @brief Конструктор кэша
+         * @param capacity Вместимость кэша >0 и < 2^31
+         * @param slow_get_func Функция для медленного получения значения
+         *
+         * @details Таблица ключей выделяется сразу, узлы - по мере заполнения
+         * @throws std::invalid_argument если вместимость вне допустимого диапазона
+         */
+        CompactLFUCache(size_t capacity, SlowGetFunc slow_get_func);
+
+        ~CompactLFUCache() noexcept = default;
+
+        /**
+         * @brief Получить значение по ключу, увеличив частоту
+         * @throws std::out_of_range если ключ не найден
+         */
+        V& get(const K& key);
+
+        /**
+         * @brief Загрузить значение в кэш (для существующего ключа - перезагрузить и увеличить частоту)
+         * @return Ссылка на значение
+         */
+        V& put(const K& key);
+
+        /**
+         * @brief Вытеснить элемент с наименьшей частотой (из них - давнее всех использованный)
+         * @throws CacheOperationException если кэш пуст
+         */
+        std::pair<K, V> evict();
+
+        bool contains(const K& key) const { return slots_[probe(key)] != 0; }
+
+        /**
+         * @brief Частота элемента (не больше kMaxFrequency)
+         * @throws std::out_of_range если ключ не найден
+         */
+        int frequencyOf(const K& key) const;
+
+        size_t size()       const { return size_; }
+        bool empty()        const { return size_ == 0; }
+        size_t capacity()   const { return capacity_; }
+
+        /**
+         * @brief Память под узлы и таблицу ключей в байтах (без внешних данных ключей и значений)
+         */
+        size_t memoryUsage() const;
+
+        /**
+         * @brief Очистить кэш (память узлов и таблицы сохраняется)
+         */
+        void clear();
+    };
+}
+
+#include "CompactLFUCache.tpp"
+
+#endif // COMPACTLFUCACHE_H
@@ -0,0 +1,145 @@
+/**
+ * @file DiskTier.h
+ * @brief Второй уровень кэша в файле: журнал только на дозапись плюс индекс в памяти
+ */
+
+#ifndef DISKTIER_H
+#define DISKTIER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <cstdint>
+#include <type_traits>
+
+#include "KeyPolicy.h"
+#include "MappedFile.h"
+#include "exceptions/StorageException.h"
+
+namespace tier
+{
+    /**
+     * @brief Файловый уровень кэша
+     * 
+     * @details Записи дописываются в конец журнала пачками, чтение идет через mmap.
+     * Индекс хранит номер последней записи для каждого ключа. При переполнении удаляются
+     * самые старые записи, когда мертвых записей становится больше живых, журнал уплотняется.
+     * Файл временный и удаляется в деструкторе
+     * 
+     * @tparam K Тип ключа (тривиально копируемый)
+     * @tparam V Тип значения (тривиально копируемый)
+     * @tparam KeyPolicy Политика хранения ключей
+     */
+    template<typename K, typename V, typename KeyPolicy = keys::HashKeys>
+    class DiskTier
+    {
+        static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                      "Disk tier stores raw records and requires trivially copyable key and value types");
+
+    private:
+        /**
+         * @brief Запись журнала
+         */
+        struct Record
+        {
+            K key;
+            V value;
+            uint64_t expire;    ///< Момент истечения TTL по часам верхнего уровня или 0
+        };
+
+        static constexpr size_t kWriteBatch = 4096;
+        static constexpr size_t kMinCompactRecords = 1 << 16;
+
+        std::string path_;
+        int fd_;
+        size_t capacity_;
+
+        /**
+         * @brief Отображение записанной части журнала (пересоздается, когда чтение выходит за его границу)
+         */
+        std::unique_ptr<storage::MappedFile> map_;
+        uint64_t flushed_records_;
+
+        /**
+         * @brief Записи, еще не сброшенные в файл
+         */
+        std::vector<Record> pending_;
+
+        /**
+         * @brief Ключ - номер его актуальной записи
+         */
+        typename KeyPolicy::template Map<K, uint64_t> index_;
+
+        /**
+         * @brief Порядок записей для удаления самых старых (может содержать устаревшие пары)
+         */
+        std::deque<std::pair<K, uint64_t>> order_;
+
+        size_t dropped_;
+        size_t compactions_;
+
+        void openLog(const std::string& path, int flags);
+        void writeRecords(const Record* records, size_t count);
+        Record readRecord(uint64_t number);
+        void dropOldest();
+        void maybeCompact();
+        void compact();
+
+    public:
+        /**
+         * @brief Создать пустой журнал
+         * @param path Путь к файлу журнала (перезаписывается)
+         * @param capacity Максимум живых записей >0
+         * 
+         * @throws StorageException если файл не удалось создать
+         */
+        DiskTier(const std::string& path, size_t capacity);
+
+        ~DiskTier() noexcept;
+
+        DiskTier(const DiskTier&) = delete;
+        DiskTier& operator=(const DiskTier&) = delete;
+
+        /**
+         * @brief Сохранить значение (более старая запись ключа становится мертвой)
+         * @param expire Момент истечения TTL, 0 - без ограничения. Уровень его только хранит
+         * 
+         * @throws StorageException если ошибка записи
+         */
+        void put(const K& key, const V& value, uint64_t expire = 0);
+
+        /**
+         * @brief Прочитать и удалить значение (для переноса на верхний уровень)
+         * @param key Ключ
+         * @param value Куда записать значение
+         * @param expire Куда записать момент истечения TTL из put() или nullptr
+         * @return true если ключ был в журнале
+         * 
+         * @throws StorageException если ошибка чтения
+         */
+        bool take(const K& key, V& value, uint64_t* expire = nullptr);
+
+        /**
+         * @brief Сбросить накопленные записи в файл
+         * 
+         * @throws StorageException если ошибка записи
+         */
+        void flush();
+
+        bool contains(const K& key) const { return index_.find(key) != index_.end(); }
+        size_t size()               const { return index_.size(); }
+        size_t capacity()           const { return capacity_; }
+        size_t droppedCount()       const { return dropped_; }
+        size_t compactionCount()    const { return compactions_; }
+
+        /**
+         * @brief Размер журнала в записях, включая мертвые
+         */
+        uint64_t logRecords() const { return flushed_records_ + pending_.size(); }
+    };
+}
+
+#include "DiskTier.tpp"
+
+#endif // DISKTIER_H
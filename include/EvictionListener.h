@@ -0,0 +1,42 @@
+/**
+ * @file EvictionListener.h
+ * @brief Интерфейс получателя уведомлений о вытеснении из кэша
+ */
+
+#ifndef EVICTIONLISTENER_H
+#define EVICTIONLISTENER_H
+
+#include <optional>
+
+namespace lfu
+{
+    /**
+     * @brief Получатель уведомлений о вытеснении
+     * 
+     * @tparam K Тип ключа
+     * @tparam V Тип значения
+     */
+    template<typename K, typename V>
+    class EvictionListener
+    {
+    public:
+        virtual ~EvictionListener() noexcept = default;
+
+        /**
+         * @brief Вызывается перед удалением элемента из кэша
+         * @param key Ключ
+         * @param value Значение
+         * @param dirty true если значение менялось после загрузки и не записано в источник
+         */
+        virtual void onEvict(const K& key, const V& value, bool dirty) = 0;
+
+        /**
+         * @brief Значение вытесненного ключа, которое получатель еще не передал в источник
+         * @details Кэш спрашивает его перед загрузкой ключа, чтобы не прочитать из источника устаревшее значение
+         * @return Значение или std::nullopt, если такого нет
+         */
+        virtual std::optional<V> lookup(const K&) { return std::nullopt; }
+    };
+}
+
+#endif // EVICTIONLISTENER_H
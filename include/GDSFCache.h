@@ -0,0 +1,163 @@
+/**
+ * @file GDSFCache.h
+ * @brief Кэш с учетом стоимости промаха (GreedyDual-Size-Frequency)
+ */
+
+#ifndef GDSFCACHE_H
+#define GDSFCACHE_H
+
+#include <map>
+#include <list>
+#include <chrono>
+#include <stdexcept>
+#include <functional>
+#include <cstdint>
+
+#include "global.h"
+#include "KeyPolicy.h"
+#include "exceptions/CacheOperationException.h"
+
+namespace lfu
+{
+    /**
+     * @brief GDSF кэш: приоритет элемента H = L + frequency * cost
+     * 
+     * @details Устроен как LFUCache, только списки элементов разложены не по частоте, а по приоритету:
+     * новый или использованный элемент кладется в начало списка своего приоритета, жертва берется
+     * с конца списка наименьшего приоритета. L (инфляция) - приоритет последней жертвы, поэтому давно
+     * не использованные элементы со временем уступают новым. Стоимость - измеренное время работы
+     * функции загрузки ключа в наносекундах, поэтому приоритеты целые и сравниваются точно.
+     * Размер всех элементов считается одинаковым
+     * 
+     * @tparam K Тип ключа
+     * @tparam V Тип значения
+     * @tparam KeyPolicy Политика хранения ключей (keys::HashKeys или keys::DenseKeys)
+     */
+    template<typename K, typename V, typename KeyPolicy = keys::HashKeys>
+    class GDSFCache
+    {
+    public:
+        /**
+         * @brief Источник времени для измерения стоимости загрузки в наносекундах
+         */
+        using Clock = std::function<uint64_t()>;
+
+    private:
+        /**
+         * @brief Структура узла кэша
+         */
+        struct Node
+        {
+            K key;
+            V value;
+            int frequency;
+            uint64_t cost;
+            uint64_t priority;
+
+            Node(const K& k, const V& v, int f, uint64_t c, uint64_t p)
+                : key(k), value(v), frequency(f), cost(c), priority(p)
+            {}
+        };
+
+        using NodeIterator = typename std::list<Node>::iterator;
+        using SlowGetFunc = std::function<V(const K&)>;
+
+        size_t capacity_;
+        SlowGetFunc slow_get_func_;
+        Clock clock_;
+        uint64_t inflation_;
+        uint64_t miss_cost_;
+        size_t load_count_;
+
+        /**
+         * @brief Списки элементов по приоритету, начало карты - наименьший приоритет
+         */
+        std::map<uint64_t, std::list<Node>> priority_map_;
+
+        /**
+         * @brief Карта ключей - итераторы на элементы
+         */
+        typename KeyPolicy::template Map<K, NodeIterator> key_map_;
+
+        /**
+         * @brief Вызвать функцию загрузки и измерить ее время
+         * @param cost Сюда записывается стоимость (не меньше 1)
+         */
+        V load(const K& key, uint64_t& cost);
+
+        /**
+         * @brief Переложить узел в список его нового приоритета
+         */
+        void reposition(NodeIterator it);
+
+    public:
+        /**
+         * @brief Конструктор кэша
+         * @param capacity Вместимость кэша >0
+         * @param slow_get_func Функция для медленного получения значения (ее время и есть стоимость промаха)
+         * 
+         * @throws std::invalid_argument если capacity == 0
+         */
+        GDSFCache(size_t capacity, SlowGetFunc slow_get_func);
+
+        ~GDSFCache() noexcept = default;
+
+        /**
+         * @brief Получить значение по ключу, увеличив частоту и приоритет
+         * @param key Ключ
+         * @return Ссылка на значение
+         * 
+         * @throws std::out_of_range если ключ не найден
+         */
+        V& get(const K& key);
+
+        /**
+         * @brief Загрузить значение в кэш
+         * @param key Ключ
+         * @return Ссылка на значение
+         * 
+         * @details Для ключа, который уже в кэше, значение и стоимость перезагружаются, частота растет
+         */
+        V& put(const K& key);
+
+        /**
+         * @brief Вытеснить элемент с наименьшим приоритетом
+         * @return Вытесненные ключ и значение
+         * @throws CacheOperationException если кэш пуст
+         */
+        std::pair<K, V> evict();
+
+        /**
+         * @brief Заменить источник времени (по умолчанию - steady_clock в наносекундах)
+         * @details Для симуляций: функция загрузки сама сдвигает виртуальное время на стоимость ключа
+         */
+        void setClock(Clock clock) { clock_ = std::move(clock); }
+
+        /**
+         * @brief Измеренная стоимость загрузки ключа
+         * @throws std::out_of_range если ключ не найден
+         */
+        uint64_t costOf(const K& key) const;
+
+        /**
+         * @brief Суммарная стоимость всех загрузок
+         */
+        uint64_t missCost()     const { return miss_cost_; }
+        size_t loadCount()      const { return load_count_; }
+        uint64_t inflation()    const { return inflation_; }
+
+        bool contains(const K& key) const { return key_map_.find(key) != key_map_.end(); }
+        size_t size()       const { return key_map_.size(); }
+        bool empty()        const { return key_map_.empty(); }
+        size_t capacity()   const { return capacity_; }
+
+        /**
+         * @brief Очистить кэш (статистика и инфляция сбрасываются)
+         */
+        void clear();
+    };
+}
+
+#include "GDSFCache.tpp"
+
+#endif // GDSFCACHE_H
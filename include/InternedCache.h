@@ -0,0 +1,108 @@
+/**
+ * @file InternedCache.h
+ * @brief LFU кэш со строковыми ключами, хранящимися в арене в единственном экземпляре
+ */
+
+#ifndef INTERNEDCACHE_H
+#define INTERNEDCACHE_H
+
+#include <string>
+#include <string_view>
+#include <functional>
+
+#include "LFUCache.h"
+#include "StringArena.h"
+#include "EvictionListener.h"
+
+namespace lfu
+{
+    /**
+     * @brief LFU кэш со строковыми ключами без лишних копий ключа
+     *
+     * @details Ключ копируется в keys::StringArena один раз при вставке, а узел кэша и таблица ключей
+     * хранят std::string_view на эту копию. Поиск принимает std::string_view и не выделяет память.
+     * Участок ключа возвращается в арену из уведомления о вытеснении, поэтому получатель уведомлений
+     * внутреннего кэша занят и наружу не предоставляется
+     *
+     * @tparam V Тип значения
+     */
+    template<typename V>
+    class InternedLFUCache
+    {
+    public:
+        using SlowGetFunc = std::function<V(std::string_view)>;
+
+    private:
+        using Inner = LFUCache<std::string_view, V, keys::StringKeys>;
+
+        /**
+         * @brief Возвращает ключи вытесненных элементов в арену
+         */
+        struct ArenaRelease : EvictionListener<std::string_view, V>
+        {
+            keys::StringArena* arena;
+
+            explicit ArenaRelease(keys::StringArena* a) : arena(a) {}
+
+            void onEvict(const std::string_view& key, const V&, bool) override
+            {
+                arena->release(key);
+            }
+        };
+
+        keys::StringArena arena_;
+        ArenaRelease release_;
+        Inner cache_;
+
+    public:
+        /**
+         * @brief Конструктор кэша
+         * @param capacity Вместимость кэша >0
+         * @param slow_get_func Функция для медленного получения значения
+         *
+         * @throws std::invalid_argument если capacity == 0
+         */
+        InternedLFUCache(size_t capacity, SlowGetFunc slow_get_func);
+
+        InternedLFUCache(const InternedLFUCache&) = delete;
+        InternedLFUCache& operator=(const InternedLFUCache&) = delete;
+
+        /**
+         * @brief Получить значение по ключу
+         * @throws std::out_of_range если ключ не найден
+         */
+        V& get(std::string_view key) { return cache_.get(key); }
+
+        /**
+         * @brief Загрузить значение в кэш (ключ копируется в арену, только если его еще нет)
+         * @return Ссылка на значение
+         */
+        V& put(std::string_view key);
+
+        /**
+         * @brief Вытеснить элемент с наименьшей частотой
+         * @return Копия ключа и значение
+         * @throws CacheOperationException если кэш пуст
+         */
+        std::pair<std::string, V> evict();
+
+        bool contains(std::string_view key) const { return cache_.contains(key); }
+        size_t size()       const { return cache_.size(); }
+        bool empty()        const { return cache_.empty(); }
+        size_t capacity()   const { return cache_.capacity(); }
+
+        /**
+         * @brief Арена ключей (для статистики памяти)
+         */
+        const keys::StringArena& arena() const { return arena_; }
+
+        /**
+         * @brief Очистить кэш и освободить память арены
+         */
+        void clear();
+    };
+}
+
+#include "InternedCache.tpp"
+
+#endif // INTERNEDCACHE_H
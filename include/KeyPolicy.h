@@ -0,0 +1,212 @@
+/**
+ * @file KeyPolicy.h
+ * @brief Политики хранения ключей для кэшей: хеш-таблицы или прямая индексация
+ */
+
+#ifndef KEYPOLICY_H
+#define KEYPOLICY_H
+
+#include <unordered_map>
+#include <functional>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+namespace keys
+{
+    /**
+     * @brief Подходит ли тип ключа для прямой индексации
+     * @details Ключ должен быть целым числом фиксированной ширины, значения - плотными и неотрицательными
+     */
+    template<typename K>
+    inline constexpr bool is_dense_key_v = std::is_integral_v<K> && !std::is_same_v<K, bool>;
+
+    /**
+     * @brief Отображение плотных целых ключей через массив, индексируемый ключом
+     * @details При росте массива значения переносятся через std::move_if_noexcept
+     *
+     * @tparam K Целочисленный тип ключа
+     * @tparam T Тип значения
+     */
+    template<typename K, typename T>
+    class DenseKeyMap
+    {
+        static_assert(is_dense_key_v<K>, "DenseKeyMap requires an integral key type");
+
+    public:
+        using value_type = std::pair<K, T>;
+
+        /**
+         * @brief Итератор по занятым ячейкам
+         */
+        template<bool Const>
+        class BasicIterator
+        {
+        private:
+            using Owner = std::conditional_t<Const, const DenseKeyMap, DenseKeyMap>;
+            using Ref = std::conditional_t<Const, const value_type&, value_type&>;
+            using Ptr = std::conditional_t<Const, const value_type*, value_type*>;
+
+            Owner* owner_;
+            size_t index_;
+
+            void skipEmpty()
+            {
+                while (index_ < owner_->present_.size() && !owner_->present_[index_])
+                {
+                    index_++;
+                }
+            }
+
+        public:
+            BasicIterator(Owner* owner, size_t index) : owner_(owner), index_(index)
+            {
+                skipEmpty();
+            }
+
+            Ref operator*()  const { return owner_->slots_[index_]; }
+            Ptr operator->() const { return &owner_->slots_[index_]; }
+
+            BasicIterator& operator++()
+            {
+                index_++;
+                skipEmpty();
+                return *this;
+            }
+
+            bool operator==(const BasicIterator& other) const { return index_ == other.index_; }
+            bool operator!=(const BasicIterator& other) const { return index_ != other.index_; }
+
+            size_t index() const { return index_; }
+        };
+
+        using iterator = BasicIterator<false>;
+        using const_iterator = BasicIterator<true>;
+
+    private:
+        std::vector<value_type> slots_;
+        std::vector<uint8_t> present_;
+        size_t size_;
+
+        /**
+         * @brief Индекс ячейки для ключа
+         * @return Индекс или slots_.size() если ключ отрицательный
+         */
+        size_t slotOf(const K& key) const;
+
+    public:
+        DenseKeyMap() : size_(0) {}
+
+        iterator begin()                { return iterator(this, 0); }
+        iterator end()                  { return iterator(this, slots_.size()); }
+        const_iterator begin()  const   { return const_iterator(this, 0); }
+        const_iterator end()    const   { return const_iterator(this, slots_.size()); }
+
+        size_t size()   const { return size_; }
+        bool empty()    const { return size_ == 0; }
+
+        iterator find(const K& key);
+        const_iterator find(const K& key) const;
+        size_t count(const K& key) const;
+
+        /**
+         * @brief Доступ с вставкой значения по умолчанию
+         *
+         * @throws std::out_of_range если ключ отрицательный
+         */
+        T& operator[](const K& key);
+
+        /**
+         * @brief Вставить значение, если ключа еще нет
+         *
+         * @throws std::out_of_range если ключ отрицательный
+         */
+        std::pair<iterator, bool> emplace(const K& key, T value);
+
+        size_t erase(const K& key);
+        void erase(iterator it);
+
+        /**
+         * @brief Зарезервировать ячейки для ключей [0, n)
+         */
+        void reserve(size_t n);
+
+        void clear();
+    };
+
+    /**
+     * @brief Политика по умолчанию: стандартные хеш-таблицы
+     */
+    struct HashKeys
+    {
+        template<typename K, typename T>
+        using Map = std::unordered_map<K, T>;
+
+        /**
+         * @brief Проверить, что ключ можно хранить в отображениях политики (подходит любой)
+         */
+        template<typename K>
+        static void validate(const K&) {}
+    };
+
+    /**
+     * @brief Политика для плотных неотрицательных целых ключей (например, номера страниц): без хеширования
+     */
+    struct DenseKeys
+    {
+        template<typename K, typename T>
+        using Map = DenseKeyMap<K, T>;
+
+        /**
+         * @brief Проверить ключ до изменения состояния кэша
+         * @throws std::out_of_range если ключ отрицательный
+         */
+        template<typename K>
+        static void validate(const K& key);
+    };
+
+    /**
+     * @brief Прозрачный хеш строк: std::string, std::string_view и const char* дают одинаковый хеш
+     * @details Не noexcept намеренно: тогда таблица хранит хеши в узлах, как для std::hash<std::string>,
+     * и не пересчитывает их при сравнении цепочек и перехешировании
+     */
+    struct StringHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view key) const
+        {
+            return std::hash<std::string_view>{}(key);
+        }
+    };
+
+    /**
+     * @brief Политика для строковых ключей: поиск по std::string_view без создания временной строки
+     * @details Отображения с нестроковыми ключами остаются обычными хеш-таблицами
+     */
+    struct StringKeys
+    {
+        template<typename K, typename T>
+        using Map = std::conditional_t<std::is_convertible_v<const K&, std::string_view>,
+                                       std::unordered_map<K, T, StringHash, std::equal_to<>>,
+                                       std::unordered_map<K, T>>;
+
+        template<typename K>
+        static void validate(const K&) {}
+    };
+
+    /**
+     * @brief Можно ли искать в отображениях политики ключом типа Q, не создавая ключ типа K
+     */
+    template<typename Policy, typename K, typename Q>
+    concept TransparentLookup = std::is_same_v<Policy, StringKeys> && !std::is_same_v<std::decay_t<Q>, K> &&
+                                std::is_convertible_v<const Q&, std::string_view>;
+}
+
+#include "KeyPolicy.tpp"
+
+#endif // KEYPOLICY_H
@@ -10,9 +10,18 @@
 #include <list>
 #include <stdexcept>
 #include <iostream>
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include <optional>
+#include <type_traits>
 
 #include "global.h"
+#include "KeyPolicy.h"
+#include "TimingWheel.h"
+#include "EvictionListener.h"
 #include "exceptions/CacheOperationException.h"
+#include "exceptions/StorageException.h"
 
 namespace lfu
 {
@@ -21,8 +30,9 @@ namespace lfu
      * 
      * @tparam K Тип ключа
      * @tparam V Тип значения
+     * @tparam KeyPolicy Политика хранения ключей (keys::HashKeys или keys::DenseKeys для плотных целых ключей)
      */
-    template<typename K, typename V>
+    template<typename K, typename V, typename KeyPolicy = keys::HashKeys>
     class LFUCache
     {
     private:
@@ -34,33 +44,88 @@ namespace lfu
             K key;      
             V value;    
             int frequency;  
+            bool dirty;
+            bool has_ttl;
+            typename timer::TimingWheel<K>::Handle timer;
             
             /**
              * @brief Конструктор узла
              * @param k Ключ
              * @param v Значение
              * @param f Начальная частота
+             * @param d Изменено ли значение относительно источника
              */
-            Node(const K& k, const V& v, int f) : key(k), value(v), frequency(f)
+            Node(const K& k, const V& v, int f, bool d = false) : key(k), value(v), frequency(f), dirty(d), has_ttl(false)
             {}
         };
         
         using NodeIterator = typename std::list<Node>::iterator;
-        using SlowGetFunc = std::function<V(K)>;
+
+    public:
+        /**
+         * @brief Источник времени для TTL в миллисекундах
+         */
+        using Clock = std::function<uint64_t()>;
+
+        /**
+         * @brief Сколько элементов по умолчанию вытесняется за одну операцию при уменьшении вместимости
+         */
+        static constexpr size_t kDefaultResizeChunk = 64;
+
+    private:
+
+        using SlowGetFunc = std::function<V(const K&)>;
         
         size_t capacity_;          
+        size_t nominal_capacity_;
+        size_t resize_chunk_;
         int min_frequency_;        
         SlowGetFunc slow_get_func_;
+        EvictionListener<K, V>* listener_;
+        Clock clock_;
+        timer::TimingWheel<K> wheel_;
+        size_t expired_count_;
         
         /**
          * @brief Карта частот т. е. список элементов с данной частотой
+         * @details Всегда хеш-таблица, независимо от KeyPolicy: частоты разрежены, и массив по частоте
+         * рос бы до наибольшего числа обращений к одному ключу
          */
         std::unordered_map<int, std::list<Node>> frequency_map_;
         
         /**
          * @brief Карта ключей - список итераторов на элементы
          */
-        std::unordered_map<K, NodeIterator> key_map_;
+        typename KeyPolicy::template Map<K, NodeIterator> key_map_;
+
+        /**
+         * @brief Заголовок бинарного снимка
+         */
+        struct SnapshotHeader
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t record_size;
+            uint64_t count;
+            uint64_t capacity;
+            int64_t min_frequency;
+            uint64_t reserved;
+        };
+
+        /**
+         * @brief Запись снимка - узел в том виде, в каком он лежит в файле
+         */
+        struct SnapshotRecord
+        {
+            K key;
+            V value;
+            int frequency;
+            int dirty;
+            int64_t ttl_left;   ///< Оставшийся срок жизни в мс или -1 если TTL не задан
+        };
+
+        static constexpr char     kSnapshotMagic[8] = {'L', 'F', 'U', 'S', 'N', 'A', 'P', '\0'};
+        static constexpr uint32_t kSnapshotVersion  = 3;
 
         /**
          * @brief Увеличивает частоту использования элемента
@@ -70,6 +135,63 @@ namespace lfu
          */
         void increase_frequency(NodeIterator it);
 
+        /**
+         * @brief Найти элемент
+         * @throws std::out_of_range если ключ не найден
+         */
+        NodeIterator find_node(const K& key);
+
+        /**
+         * @brief Вставить новый элемент с частотой 1, вытеснив жертву при заполнении
+         */
+        V& insert_node(const K& key, V value, bool dirty);
+
+        /**
+         * @brief Загрузить значение: сначала из получателя уведомлений (еще не записанное), затем из источника
+         */
+        V load(const K& key);
+
+        /**
+         * @brief Удалить узел из всех структур (вместе с его таймером)
+         */
+        void remove_node(NodeIterator it);
+
+        /**
+         * @brief Удалить истекший узел, сообщив получателю уведомлений
+         */
+        void expire_node(NodeIterator it);
+
+        /**
+         * @brief Истек ли срок жизни узла к моменту now
+         */
+        bool is_expired(const Node& node, uint64_t now) const;
+
+        /**
+         * @brief Найти элемент, удалив его, если срок жизни истек
+         * @param key Ключ типа K или тип прозрачного поиска политики
+         * @return Итератор на узел или NodeIterator() если элемента нет
+         */
+        template<typename Q>
+        NodeIterator find_live(const Q& key);
+
+        /**
+         * @brief Задать или снять TTL узла
+         * @param ttl Срок жизни, <= 0 - без ограничения
+         */
+        void set_ttl(NodeIterator it, std::chrono::milliseconds ttl, uint64_t now);
+
+        /**
+         * @brief Ранг вытеснения узла (см. evictionRank)
+         */
+        size_t eviction_rank(const Node& node, size_t limit) const;
+
+        /**
+         * @brief Продвинуть колесо таймеров до now и удалить истекшие элементы
+         * @param first Если не nullptr - сюда переносится первый удаленный элемент
+         * @return Число удаленных элементов
+         */
+        size_t reclaim_expired(uint64_t now, std::optional<std::pair<K, V>>* first = nullptr);
+
     public:
         /**
          * @brief Конструктор кэша
@@ -87,7 +209,9 @@ namespace lfu
          * @param key Ключ
          * @return Ссылка на значение
          * 
-         * @throws std::out_of_range если ключ не найден
+         * @details Элемент с истекшим TTL удаляется при обращении и считается отсутствующим
+         * 
+         * @throws std::out_of_range если ключ не найден или срок его жизни истек
          * @throws CacheOperationException если ошибка операции
          */
         V& get(const K& key);
@@ -95,18 +219,165 @@ namespace lfu
         /**
          * @brief Поместить значение в кэш
          * @param key Ключ
+         * @return Ссылка на загруженное значение
+         * 
+         * @details Для уже измененного (dirty) элемента значение не перезагружается,
+         * так как оно новее, чем в источнике - увеличивается только частота
+         */
+        V& put(const K& key);
+
+        /**
+         * @brief Поместить значение в кэш с ограниченным сроком жизни
+         * @param key Ключ
+         * @param ttl Срок жизни от текущего момента, <= 0 - без ограничения
+         * @return Ссылка на загруженное значение
+         * 
+         * @details Срок жизни уже находящегося в кэше элемента отсчитывается заново
          */
-        void put(const K& key);
+        V& put(const K& key, std::chrono::milliseconds ttl);
+
+        /**
+         * @brief Получить значение для изменения: элемент помечается измененным
+         * @param key Ключ
+         * @return Ссылка на значение
+         * 
+         * @throws std::out_of_range если ключ не найден
+         */
+        V& getMutable(const K& key);
+
+        /**
+         * @brief Записать новое значение без обращения к источнику, элемент помечается измененным
+         * @param key Ключ (если его нет - элемент вставляется)
+         * @param value Значение
+         */
+        void update(const K& key, V value);
+
+        /**
+         * @brief Записать новое значение с ограниченным сроком жизни
+         * @param key Ключ (если его нет - элемент вставляется)
+         * @param value Значение
+         * @param ttl Срок жизни от текущего момента, <= 0 - без ограничения
+         */
+        void update(const K& key, V value, std::chrono::milliseconds ttl);
+
+        /**
+         * @brief Задать срок жизни элемента, уже находящегося в кэше
+         * @param key Ключ
+         * @param ttl Срок жизни от текущего момента, <= 0 - снять ограничение
+         * 
+         * @throws std::out_of_range если ключ не найден или срок его жизни уже истек
+         */
+        void setTTL(const K& key, std::chrono::milliseconds ttl);
+
+        /**
+         * @brief Удалить все элементы с истекшим сроком жизни
+         * @return Число удаленных элементов
+         * 
+         * @details put() делает это сам, явный вызов нужен, например, по таймеру в простое
+         */
+        size_t reclaimExpired();
+
+        /**
+         * @brief Заменить источник времени (по умолчанию - steady_clock в миллисекундах)
+         * @details Нужно для тестов и симуляций. Вызывать до назначения первого TTL
+         */
+        void setClock(Clock clock) { clock_ = std::move(clock); }
+
+        /**
+         * @brief Текущее время источника для TTL в мс
+         */
+        uint64_t now() const { return clock_(); }
+
+        /**
+         * @brief Сколько элементов удалено по истечении срока жизни
+         */
+        size_t expiredCount() const { return expired_count_; }
+
+        /**
+         * @brief Пометить элемент измененным
+         * @throws std::out_of_range если ключ не найден
+         */
+        void markDirty(const K& key);
+
+        /**
+         * @brief Изменен ли элемент
+         * @throws std::out_of_range если ключ не найден
+         */
+        bool isDirty(const K& key) const;
+
+        /**
+         * @brief Установить получателя уведомлений о вытеснении
+         * @param listener Получатель (не принадлежит кэшу и должен его пережить) или nullptr
+         */
+        void setEvictionListener(EvictionListener<K, V>* listener) { listener_ = listener; }
         
         /**
          * @brief Вытеснить один элемент из кэша
+         * @return Вытесненные ключ и значение
+         * 
+         * @details Если есть элементы с истекшим TTL, удаляются все они, а возвращается первый из них;
+         * иначе вытесняется элемент с наименьшей частотой
+         * 
          * @throws CacheOperationException если кэш пуст
          */
-        void evict();
+        std::pair<K, V> evict();
+
+        /**
+         * @brief Вытеснить один элемент, сообщив, истек ли его TTL
+         * @param expired true если возвращен элемент с истекшим TTL (его значение устарело)
+         * @param expire Куда записать момент истечения TTL живого элемента (0 если TTL не задан) или nullptr
+         * 
+         * @throws CacheOperationException если кэш пуст
+         */
+        std::pair<K, V> evict(bool& expired, uint64_t* expire = nullptr);
         
+        /**
+         * @brief Есть ли ключ в кэше (без изменения частоты и проверки TTL)
+         */
+        bool contains(const K& key) const { return key_map_.find(key) != key_map_.end(); }
+
+        /**
+         * @brief Сколько элементов будет вытеснено раньше данного (не больше limit)
+         * @details Частоты перебираются от минимальной, пока не набрано limit элементов, но не больше,
+         * чем их есть в кэше: O(min(разность частот, число частот) + limit). Частота и порядок не меняются
+         * 
+         * @throws std::out_of_range если ключ не найден
+         */
+        size_t evictionRank(const K& key, size_t limit) const;
+
+        /**
+         * @brief То же без исключения
+         * @param rank Куда записать ранг, если ключ есть
+         * @return true если ключ есть в кэше
+         */
+        bool evictionRank(const K& key, size_t limit, size_t& rank) const;
+
+        /**
+         * @brief Получить значение по ключу другого типа, не создавая K (например, std::string_view при K = std::string)
+         * @details Доступно для политик с прозрачным поиском (keys::StringKeys)
+         * @throws std::out_of_range если ключ не найден
+         */
+        template<typename Q> requires keys::TransparentLookup<KeyPolicy, K, Q>
+        V& get(const Q& key);
+
+        /**
+         * @brief Есть ли ключ в кэше (прозрачный поиск, без изменения частоты)
+         */
+        template<typename Q> requires keys::TransparentLookup<KeyPolicy, K, Q>
+        bool contains(const Q& key) const { return key_map_.find(key) != key_map_.end(); }
+
+        /**
+         * @brief Обойти непустые списки частот
+         * @param func Вызывается как func(частота, число элементов) в неопределенном порядке
+         * 
+         * @details O(число различных частот), для снятия статистики во время работы
+         */
+        template<typename Func>
+        void forEachFrequency(Func&& func) const;
+
         /**
          * @brief Получить текущий размер кэша
-         * @return Количество элементов в кэше
+         * @return Количество элементов в кэше (включая истекшие, но еще не удаленные)
          */
         size_t size() const;
         
@@ -122,10 +393,84 @@ namespace lfu
          */
         size_t capacity() const;
         
+        /**
+         * @brief Изменить вместимость без перестроения кэша
+         * @param new_capacity Новая вместимость >0 (становится и номинальной)
+         * 
+         * @details Рост применяется сразу. При уменьшении за вызов вытесняется не больше
+         * resizeChunk() элементов по обычному правилу LFU, остальные - такими же порциями
+         * в следующих put()/update() или через resizeStep(), поэтому длинных пауз нет.
+         * До завершения size() может превышать capacity(). История частот сохраняется
+         * 
+         * @throws std::invalid_argument если new_capacity == 0
+         */
+        void resize(size_t new_capacity);
+
+        /**
+         * @brief Вытеснить очередную порцию лишних элементов после уменьшения вместимости
+         * @return Сколько элементов еще осталось вытеснить
+         */
+        size_t resizeStep();
+
+        /**
+         * @brief Сколько элементов осталось вытеснить до новой вместимости
+         */
+        size_t shrinkPending() const { return key_map_.size() > capacity_ ? key_map_.size() - capacity_ : 0; }
+
+        /**
+         * @brief Задать размер порции вытеснения при уменьшении вместимости
+         * @param chunk Элементов за операцию >0 (SIZE_MAX - вытеснять все сразу)
+         * 
+         * @throws std::invalid_argument если chunk == 0
+         */
+        void setResizeChunk(size_t chunk);
+
+        size_t resizeChunk() const { return resize_chunk_; }
+
+        /**
+         * @brief Реакция на нехватку памяти
+         * @param level Доля номинальной вместимости, которую нужно освободить, от 0 (нет давления) до 1
+         * 
+         * @details Вместимость становится max(1, nominal * (1 - level)), номинальная не меняется,
+         * поэтому при спаде давления (level = 0) кэш снова растет до нее. Уменьшение идет порциями, как в resize()
+         * 
+         * @throws std::invalid_argument если level вне [0, 1]
+         */
+        void onMemoryPressure(double level);
+
+        /**
+         * @brief Вместимость, заданная в конструкторе или последним resize()
+         */
+        size_t nominalCapacity() const { return nominal_capacity_; }
+        
         /**
          * @brief Очистить кэш
+         * @details Получатель уведомлений узнает об измененных элементах, чтобы их можно было записать
          */
         void clear();
+
+        /**
+         * @brief Сохранить ключи, значения и частоты в бинарный снимок
+         * @param path Путь к файлу снимка
+         * 
+         * @details Узлы пишутся группами по частоте в порядке списков,
+         * поэтому после загрузки порядок вытеснения не меняется. Для элементов с TTL
+         * сохраняется оставшийся срок жизни
+         * 
+         * @throws StorageException если файл не удалось записать
+         */
+        void saveSnapshot(const std::string& path) const;
+
+        /**
+         * @brief Восстановить кэш из снимка за O(n)
+         * @param path Путь к файлу снимка
+         * 
+         * @details Файл отображается через mmap, записи читаются напрямую
+         * без разбора. Минимальная частота пересчитывается по записям. Текущее содержимое кэша заменяется
+         * 
+         * @throws StorageException если файл поврежден, частота записи не положительна или записей больше, чем capacity
+         */
+        void loadSnapshot(const std::string& path);
     };
 }
 
@@ -0,0 +1,104 @@
+/**
+ * @file LRUCache.h
+ * @brief Заголовочный файл для LRU кэша
+ */
+
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+#include <list>
+#include <stdexcept>
+#include <functional>
+
+#include "global.h"
+#include "KeyPolicy.h"
+#include "exceptions/CacheOperationException.h"
+
+namespace lru
+{
+    /**
+     * @brief LRU кэш
+     * 
+     * @tparam K Тип ключа
+     * @tparam V Тип значения
+     * @tparam KeyPolicy Политика хранения ключей (keys::HashKeys или keys::DenseKeys)
+     */
+    template<typename K, typename V, typename KeyPolicy = keys::HashKeys>
+    class LRUCache
+    {
+    private:
+        /**
+         * @brief Структура узла кэша
+         */
+        struct Node
+        {
+            K key;
+            V value;
+
+            Node(const K& k, const V& v) : key(k), value(v)
+            {}
+        };
+
+        using NodeIterator = typename std::list<Node>::iterator;
+        using SlowGetFunc = std::function<V(const K&)>;
+
+        size_t capacity_;
+        SlowGetFunc slow_get_func_;
+
+        /**
+         * @brief Элементы от самого свежего (начало) к самому старому (конец)
+         */
+        std::list<Node> recency_list_;
+
+        /**
+         * @brief Карта ключей - итераторы на элементы списка
+         */
+        typename KeyPolicy::template Map<K, NodeIterator> key_map_;
+
+    public:
+        /**
+         * @brief Конструктор кэша
+         * @param capacity Вместимость кэша >0
+         * @param slow_get_func Функция для медленного получения значения
+         * 
+         * @throws std::invalid_argument если capacity == 0
+         */
+        LRUCache(size_t capacity, SlowGetFunc slow_get_func);
+
+        ~LRUCache() noexcept = default;
+
+        /**
+         * @brief Получить значение по ключу и сделать его самым свежим
+         * @param key Ключ
+         * @return Ссылка на значение
+         * 
+         * @throws std::out_of_range если ключ не найден
+         */
+        V& get(const K& key);
+
+        /**
+         * @brief Поместить значение в кэш
+         * @param key Ключ
+         */
+        void put(const K& key);
+
+        /**
+         * @brief Вытеснить самый старый элемент
+         * @throws CacheOperationException если кэш пуст
+         */
+        void evict();
+
+        size_t size()       const { return key_map_.size(); }
+        bool empty()        const { return key_map_.empty(); }
+        size_t capacity()   const { return capacity_; }
+
+        /**
+         * @brief Очистить кэш
+         */
+        void clear();
+    };
+}
+
+#include "LRUCache.tpp"
+
+#endif // LRUCACHE_H
@@ -0,0 +1,85 @@
+/**
+ * @file MappedFile.h
+ * @brief Отображение файла в память только для чтения (RAII обертка над mmap)
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "exceptions/StorageException.h"
+
+namespace storage
+{
+    /**
+     * @brief Файл, отображенный в память только для чтения
+     */
+    class MappedFile
+    {
+    private:
+        const char* data_;
+        size_t size_;
+
+    public:
+        /**
+         * @brief Отобразить файл целиком
+         * @param path Путь к файлу
+         * @param sequential Подсказка ядру о последовательном чтении (для снимков), иначе - о случайном
+         *
+         * @throws StorageException если файл не удалось открыть или отобразить
+         */
+        explicit MappedFile(const std::string& path, bool sequential = true) : data_(nullptr), size_(0)
+        {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw StorageException("Cannot open file " + path);
+            }
+
+            struct stat st;
+            if (::fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                throw StorageException("Cannot stat file " + path);
+            }
+
+            size_ = static_cast<size_t>(st.st_size);
+            if (size_ > 0)
+            {
+                void* ptr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+                if (ptr == MAP_FAILED)
+                {
+                    ::close(fd);
+                    throw StorageException("Cannot map file " + path);
+                }
+                ::madvise(ptr, size_, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+                data_ = static_cast<const char*>(ptr);
+            }
+
+            ::close(fd);
+        }
+
+        ~MappedFile() noexcept
+        {
+            if (data_ != nullptr)
+            {
+                ::munmap(const_cast<char*>(data_), size_);
+            }
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data()  const { return data_; }
+        size_t size()       const { return size_; }
+    };
+}
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,116 @@
+/**
+ * @file NextUseIndex.h
+ * @brief Индекс следующего обращения для оптимального кэша: next[i] - позиция следующего запроса того же ключа
+ * @details Строится один раз на трассу (параллельно по отрезкам) и разделяется между кэшами только для чтения.
+ * Может сохраняться в файл с сигнатурой LFUNEXT и отображаться обратно в память без копирования
+ */
+
+#ifndef NEXTUSEINDEX_H
+#define NEXTUSEINDEX_H
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+
+#include "KeyPolicy.h"
+#include "MappedFile.h"
+#include "exceptions/StorageException.h"
+
+namespace opt
+{
+    /**
+     * @brief Заголовок файла индекса, за ним count значений uint64
+     */
+    struct NextUseHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t count;
+        uint64_t trace_hash;    ///< Хеш трассы, по которой построен индекс
+        uint64_t checksum;      ///< Контрольная сумма значений
+    };
+
+    inline constexpr char     kNextUseMagic[8] = {'L', 'F', 'U', 'N', 'E', 'X', 'T', '\0'};
+    inline constexpr uint32_t kNextUseVersion  = 1;
+
+    /**
+     * @brief Неизменяемый индекс следующего обращения
+     */
+    class NextUseIndex
+    {
+    public:
+        /**
+         * @brief Значение для запросов, после которых ключ больше не встречается
+         */
+        static constexpr uint64_t kNever = std::numeric_limits<uint64_t>::max();
+
+    private:
+        std::vector<uint64_t> owned_;
+        std::unique_ptr<storage::MappedFile> file_;
+        const uint64_t* next_;
+        size_t size_;
+        uint64_t trace_hash_;
+
+        NextUseIndex() : next_(nullptr), size_(0), trace_hash_(0) {}
+
+        static uint64_t checksum(const uint64_t* values, size_t count);
+
+    public:
+        NextUseIndex(const NextUseIndex&) = delete;
+        NextUseIndex& operator=(const NextUseIndex&) = delete;
+
+        /**
+         * @brief Хеш трассы для проверки, что сохраненный индекс построен по ней же
+         */
+        template<typename K>
+        static uint64_t traceHash(const std::vector<K>& requests);
+
+        /**
+         * @brief Построить индекс
+         * @param requests Трасса
+         * @param threads Число потоков, 0 - по числу ядер. Трасса делится на отрезки, каждый поток
+         * связывает обращения внутри своего отрезка, затем последние обращения ключей в отрезках
+         * сшиваются с первыми обращениями в следующих
+         *
+         * @tparam KeyPolicy Политика карт ключей для построения
+         */
+        template<typename K, typename KeyPolicy = keys::HashKeys>
+        static std::shared_ptr<const NextUseIndex> build(const std::vector<K>& requests, size_t threads = 0);
+
+        /**
+         * @brief Отобразить сохраненный индекс
+         * @param path Путь к файлу
+         * @param trace_hash Ожидаемый хеш трассы
+         *
+         * @throws StorageException если файла нет, он поврежден или построен по другой трассе
+         */
+        static std::shared_ptr<const NextUseIndex> load(const std::string& path, uint64_t trace_hash);
+
+        /**
+         * @brief Сохранить индекс
+         * @throws StorageException если запись не удалась
+         */
+        void save(const std::string& path) const;
+
+        /**
+         * @brief Позиция следующего запроса того же ключа после запроса position или kNever
+         */
+        uint64_t next(size_t position) const { return next_[position]; }
+
+        size_t size()           const { return size_; }
+        uint64_t traceHash()    const { return trace_hash_; }
+
+        /**
+         * @brief Отображен ли индекс из файла
+         */
+        bool mapped()           const { return file_ != nullptr; }
+    };
+}
+
+#include "NextUseIndex.tpp"
+
+#endif // NEXTUSEINDEX_H
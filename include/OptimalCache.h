@@ -7,15 +7,19 @@
 #define OPTIMALCACHE_H
 
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
-#include <queue>
+#include <memory>
 #include <functional>
 #include <limits>
 #include <iostream>
 #include <string>
+#include <chrono>
+#include <cstdint>
 
 #include "global.h"
+#include "KeyPolicy.h"
+#include "ArgMax.h"
+#include "NextUseIndex.h"
 #include "exceptions/CacheOperationException.h"
 
 namespace opt
@@ -25,59 +29,103 @@ namespace opt
      * 
      * @tparam K Тип ключа
      * @tparam V Тип значения
+     * @tparam KeyPolicy Политика хранения ключей (keys::HashKeys или keys::DenseKeys для плотных целых ключей)
      */
-    template<typename K, typename V>
+    template<typename K, typename V, typename KeyPolicy = keys::HashKeys>
     class OptimalCache
     {
+    public:
+        /**
+         * @brief Источник времени для измерения стоимости загрузки в наносекундах
+         */
+        using Clock = std::function<uint64_t()>;
+
     private:
         size_t capacity_;                  
-        std::function<V(K)> slow_get_func_;  
+        std::function<V(const K&)> slow_get_func_;  
+        Clock clock_;
+        bool cost_aware_;
+        bool track_cost_;
         
         /**
-         * @brief Будущие индексы
-
-        */
-        std::unordered_map<K, std::queue<size_t>> future_indices_;
+         * @brief Индекс следующего обращения для каждой позиции трассы (общий для кэшей на одной трассе)
+         */
+        std::shared_ptr<const NextUseIndex> index_;
         
         /**
-         * @brief Ключи в кэше
+         * @brief Резидентные элементы в виде структуры массивов: слот i хранит ключ, значение
+         * и момент следующего обращения. Массив slot_next_use_ непрерывен, по нему идет поиск жертвы
          */
-        std::unordered_set<K> current_cache_;
+        std::vector<K> slot_keys_;
+        std::vector<V> slot_values_;
+        std::vector<size_t> slot_next_use_;
+        std::vector<uint64_t> slot_cost_;
         
         /**
-         * @brief Значения в кэше
+         * @brief Номер слота для каждого ключа в кэше
          */
-        std::unordered_map<K, V> cache_values_;
+        typename KeyPolicy::template Map<K, size_t> slot_of_;
         
         size_t hit_count_;    
         size_t miss_count_;   
         size_t current_step_; 
+        uint64_t miss_cost_;
+
+        /**
+         * @brief Находит слот для вытеснения - элемент с самым дальним следующим обращением
+         * @return Номер слота
+         */
+        size_t findEvictionSlot() const;
 
         /**
-         * @brief Находит ключ для вытеснения из кэша
-         * @return Ключ для вытеснения
+         * @brief Слот для вытеснения с учетом стоимости: наибольшее (расстояние до следующего обращения) / стоимость
+         * @details Элементы без будущих обращений вытесняются первыми
+         * @return Номер слота
          */
-        K findEvictionKey();
+        size_t findCostAwareSlot() const;
 
     public:
         /**
          * @brief Конструктор оптимального кэша
          */
-        OptimalCache(size_t capacity, std::function<V(K)> slow_get_func);
+        OptimalCache(size_t capacity, std::function<V(const K&)> slow_get_func);
         
         ~OptimalCache() noexcept = default;
         
         /**
-         * @brief Предобработка последовательности запросов
+         * @brief Предобработка последовательности запросов: построить индекс следующего обращения
+         * @param threads Число потоков построения, 0 - автоматически
          */
-        void preprocessRequests(const std::vector<K>& requests);
+        void preprocessRequests(const std::vector<K>& requests, size_t threads = 0);
+
+        /**
+         * @brief Использовать готовый индекс вместо preprocessRequests() и очистить состояние кэша
+         * @details Индекс только читается, поэтому один экземпляр можно отдать всем кэшам на этой трассе
+         * 
+         * @throws std::invalid_argument если index == nullptr
+         */
+        void setNextUseIndex(std::shared_ptr<const NextUseIndex> index);
+
+        /**
+         * @brief Текущий индекс следующего обращения (nullptr до предобработки)
+         */
+        std::shared_ptr<const NextUseIndex> getNextUseIndex() const { return index_; }
         
         /**
          * @brief Симуляция работы кэша
+         * @param requests Та же трасса, по которой построен индекс
          * 
-         * @throws CacheOperationException если не была вызвана preprocessRequests()
+         * @throws CacheOperationException если не была вызвана preprocessRequests() или длина трассы другая
          */
         size_t simulate(const std::vector<K>& requests);
+
+        /**
+         * @brief Обработать очередной запрос трассы
+         * @param key Ключ запроса с номером, равным числу уже сделанных шагов
+         * @return true при попадании
+         * 
+         * @throws CacheOperationException если индекса нет или трасса уже пройдена
+         */
         bool step(const K& key);
         
         /**
@@ -96,9 +144,9 @@ namespace opt
         
 
 
-        size_t getCurrentSize()         const { return current_cache_.size(); }
+        size_t getCurrentSize()         const { return slot_keys_.size(); }
         size_t getCapacity()            const { return capacity_; }
-        bool contains(const K& key)     const { return current_cache_.find(key) != current_cache_.end(); }
+        bool contains(const K& key)     const { return slot_of_.find(key) != slot_of_.end(); }
         size_t getHitCount()            const { return hit_count_; }
         
 
@@ -108,6 +156,38 @@ namespace opt
 
         double getHitRate() const;
 
+        /**
+         * @brief Суммарная измеренная стоимость загрузок (промахов)
+         * @details Считается, только если включен учет стоимости (см. setCostTracking), иначе 0
+         */
+        uint64_t getMissCost() const { return miss_cost_; }
+
+        /**
+         * @brief Выбирать жертву с учетом стоимости загрузки
+         * 
+         * @details Вытесняется элемент с наибольшим отношением расстояния до следующего обращения
+         * к измеренной стоимости его загрузки: дешевые и дальние уходят первыми. Это эвристика,
+         * а не точный оптимум по стоимости (для него нужна задача о потоке минимальной стоимости),
+         * но при равных стоимостях она совпадает с Belady
+         */
+        void setCostAware(bool cost_aware) { cost_aware_ = cost_aware; }
+
+        /**
+         * @brief Измерять стоимость загрузок без учета ее при вытеснении
+         * @details Без этого и без setCostAware промах не обращается к часам
+         */
+        void setCostTracking(bool track_cost) { track_cost_ = track_cost; }
+
+        /**
+         * @brief Заменить источник времени (по умолчанию - steady_clock в наносекундах)
+         * @details Включает учет стоимости
+         */
+        void setClock(Clock clock)
+        {
+            clock_ = std::move(clock);
+            track_cost_ = true;
+        }
+
 
 
         /**
@@ -116,7 +196,8 @@ namespace opt
         void clear();
         
         /**
-         * @brief Получить следующее использование
+         * @brief Момент следующего обращения к элементу в кэше
+         * @return Позиция в трассе или max(size_t) если обращений больше нет или ключа нет в кэше
          */
         size_t getNextUse(const K& key) const;
     };
@@ -0,0 +1,170 @@
+/**
+ * @file PartitionedCache.h
+ * @brief Кэш с общим бюджетом, разделенным между арендаторами, и динамическим перераспределением
+ */
+
+#ifndef PARTITIONEDCACHE_H
+#define PARTITIONEDCACHE_H
+
+#include <vector>
+#include <list>
+#include <memory>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+
+#include "LFUCache.h"
+#include "KeyPolicy.h"
+#include "EvictionListener.h"
+#include "exceptions/ConfigurationException.h"
+
+namespace part
+{
+    /**
+     * @brief Настройки перераспределения
+     */
+    struct PartitionOptions
+    {
+        /**
+         * @brief Сколько элементов переносится за одно перераспределение (0 - 1/16 доли арендатора)
+         */
+        size_t rebalance_step = 0;
+
+        /**
+         * @brief Число запросов между перераспределениями
+         */
+        size_t epoch_length = 1000;
+
+        /**
+         * @brief Минимальная вместимость арендатора
+         */
+        size_t min_capacity = 1;
+    };
+
+    /**
+     * @brief Набор LFU кэшей арендаторов с общим бюджетом
+     * 
+     * @details Оценки строятся только по step ключам у границы каждого кэша. Промах по одному из step
+     * последних вытесненных ключей (теневой список) - выигрыш, который дали бы step дополнительных
+     * элементов. Попадание в один из step элементов, которые будут вытеснены следующими, - потеря
+     * при уменьшении на step. Раз в эпоху step элементов переходят от арендатора с наименьшей
+     * потерей к арендатору с наибольшим выигрышем, если выигрыш больше
+     * 
+     * @tparam K Тип ключа
+     * @tparam V Тип значения
+     * @tparam KeyPolicy Политика хранения ключей
+     */
+    template<typename K, typename V, typename KeyPolicy = keys::HashKeys>
+    class PartitionedCache
+    {
+    private:
+        using Cache = lfu::LFUCache<K, V, KeyPolicy>;
+        using SlowGetFunc = std::function<V(const K&)>;
+
+        /**
+         * @brief Ключи, недавно вытесненные из кэша арендатора (не больше limit, без значений)
+         * @details Занимает место получателя уведомлений кэша, поэтому передает их дальше получателю арендатора
+         */
+        struct GhostList : lfu::EvictionListener<K, V>
+        {
+            size_t limit;
+            std::list<K> keys;
+            typename KeyPolicy::template Map<K, typename std::list<K>::iterator> index;
+            lfu::EvictionListener<K, V>* next;
+
+            explicit GhostList(size_t l) : limit(l), next(nullptr) {}
+
+            void onEvict(const K& key, const V& value, bool dirty) override;
+            std::optional<V> lookup(const K& key) override;
+
+            /**
+             * @brief Убрать ключ из списка
+             * @return true если он там был
+             */
+            bool take(const K& key);
+        };
+
+        /**
+         * @brief Состояние одного арендатора
+         */
+        struct Tenant
+        {
+            std::unique_ptr<Cache> cache;
+            std::unique_ptr<GhostList> ghost;
+
+            double gain = 0.0;
+            double loss = 0.0;
+            size_t hits = 0;
+            size_t requests = 0;
+        };
+
+        size_t total_capacity_;
+        PartitionOptions options_;
+        std::vector<Tenant> tenants_;
+        size_t requests_in_epoch_;
+        size_t rebalance_count_;
+
+        Tenant& tenantAt(size_t tenant);
+        const Tenant& tenantAt(size_t tenant) const;
+
+    public:
+        /**
+         * @brief Конструктор, бюджет изначально делится поровну
+         * @param total_capacity Общая вместимость
+         * @param tenant_count Число арендаторов >0
+         * @param slow_get_func Функция для медленного получения значения
+         * @param options Настройки перераспределения
+         * 
+         * @throws ConfigurationException если бюджета не хватает на min_capacity каждому
+         */
+        PartitionedCache(size_t total_capacity, size_t tenant_count, SlowGetFunc slow_get_func,
+                         PartitionOptions options = PartitionOptions());
+
+        ~PartitionedCache() noexcept = default;
+
+        /**
+         * @brief Запрос арендатора: попадание или загрузка в его кэш
+         * @param tenant Номер арендатора
+         * @param key Ключ
+         * @return true если было попадание
+         * 
+         * @throws std::out_of_range если арендатора нет
+         */
+        bool access(size_t tenant, const K& key);
+
+        /**
+         * @brief Перенести step элементов бюджета, если это выгодно
+         * @return true если вместимости изменились
+         */
+        bool rebalance();
+
+        /**
+         * @brief Установить получателя уведомлений о вытеснении из кэша арендатора
+         * @param tenant Номер арендатора
+         * @param listener Получатель (не принадлежит кэшу и должен его пережить) или nullptr
+         * 
+         * @details Теневой список остается подключен к кэшу и передает уведомления получателю
+         * 
+         * @throws std::out_of_range если арендатора нет
+         */
+        void setEvictionListener(size_t tenant, lfu::EvictionListener<K, V>* listener) { tenantAt(tenant).ghost->next = listener; }
+
+        size_t tenantCount()        const { return tenants_.size(); }
+        size_t totalCapacity()      const { return total_capacity_; }
+        size_t rebalanceCount()     const { return rebalance_count_; }
+
+        size_t capacityOf(size_t tenant)    const { return tenantAt(tenant).cache->capacity(); }
+        size_t sizeOf(size_t tenant)        const { return tenantAt(tenant).cache->size(); }
+        size_t hitCount(size_t tenant)      const { return tenantAt(tenant).hits; }
+        size_t requestCount(size_t tenant)  const { return tenantAt(tenant).requests; }
+
+        /**
+         * @brief Сколько вытесненных ключей арендатора помнит теневой список (не больше rebalance_step)
+         */
+        size_t ghostSizeOf(size_t tenant)   const { return tenantAt(tenant).ghost->keys.size(); }
+    };
+}
+
+#include "PartitionedCache.tpp"
+
+#endif // PARTITIONEDCACHE_H
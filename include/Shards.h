@@ -0,0 +1,102 @@
+/**
+ * @file Shards.h
+ * @brief Пространственная выборка ключей для оценки кривых промахов (в стиле SHARDS)
+ * @details Ключ попадает в выборку, если hash(key) mod P < T. Размер кэша масштабируется
+ * с коэффициентом R = T / P, промахи на выборке оценивают промахи на полной трассе
+ */
+
+#ifndef SHARDS_H
+#define SHARDS_H
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+#include "exceptions/ConfigurationException.h"
+
+namespace shards
+{
+    /**
+     * @brief Перемешивание 64-битного значения (финализатор splitmix64)
+     */
+    inline uint64_t mix64(uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * @brief Оценка с симметричной границей погрешности
+     */
+    struct Estimate
+    {
+        double mean;
+        double error;
+    };
+
+    /**
+     * @brief Среднее по независимым выборкам и 95% доверительный интервал
+     * @param values Оценки, полученные с разными seed
+     * @return Среднее и полуширина интервала (0 при одной выборке)
+     */
+    Estimate summarize(const std::vector<double>& values);
+
+    /**
+     * @brief Пространственный сэмплер ключей
+     * 
+     * @tparam K Тип ключа (должен поддерживать std::hash)
+     */
+    template<typename K>
+    class SpatialSampler
+    {
+    private:
+        uint64_t seed_;
+        uint64_t modulus_;
+        uint64_t threshold_;
+
+    public:
+        /**
+         * @brief Конструктор сэмплера
+         * @param rate Доля ключей в выборке, (0, 1]
+         * @param seed Соль хеша: разные seed дают независимые выборки
+         * @param modulus Модуль P
+         * 
+         * @throws ConfigurationException если rate вне (0, 1] или слишком мал для модуля
+         */
+        SpatialSampler(double rate, uint64_t seed = 0, uint64_t modulus = 1ULL << 24);
+
+        /**
+         * @brief Попадает ли ключ в выборку
+         */
+        bool keep(const K& key) const
+        {
+            return mix64(static_cast<uint64_t>(std::hash<K>{}(key)) ^ mix64(seed_)) % modulus_ < threshold_;
+        }
+
+        /**
+         * @brief Фактическая доля выборки T / P
+         */
+        double rate() const { return static_cast<double>(threshold_) / static_cast<double>(modulus_); }
+
+        /**
+         * @brief Размер кэша для выборки
+         * @param cache_size Размер кэша на полной трассе
+         * @return Масштабированный размер, не меньше 1
+         */
+        size_t scaleCacheSize(size_t cache_size) const;
+
+        /**
+         * @brief Отфильтровать последовательность запросов
+         * @param requests Полная последовательность
+         * @return Запросы к ключам из выборки в исходном порядке
+         */
+        std::vector<K> sample(const std::vector<K>& requests) const;
+    };
+}
+
+#include "Shards.tpp"
+
+#endif // SHARDS_H
@@ -0,0 +1,79 @@
+/**
+ * @file StringArena.h
+ * @brief Хранилище строковых ключей: каждая строка копируется один раз в общие блоки памяти
+ */
+
+#ifndef STRINGARENA_H
+#define STRINGARENA_H
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <string_view>
+#include <cstddef>
+
+namespace keys
+{
+    /**
+     * @brief Арена для строк с повторным использованием освобожденных участков
+     *
+     * @details Строка занимает участок размера 2^k >= 16 байт. Короткие участки нарезаются из блоков
+     * по kBlockSize байт, длинные выделяются отдельно. Освобожденный участок попадает в список своего
+     * размера и его содержимое не меняется до следующего intern(), поэтому ключ, который кэш отдает
+     * вместе с уведомлением о вытеснении, еще можно прочитать. Память возвращается системе только clear()
+     */
+    class StringArena
+    {
+    public:
+        static constexpr size_t kBlockSize = 64 * 1024;
+        static constexpr size_t kMinClass = 4;      ///< Наименьший участок - 16 байт
+
+    private:
+        static constexpr size_t kClasses = 48;
+
+        std::vector<std::unique_ptr<char[]>> blocks_;
+        char* cursor_;
+        size_t remaining_;
+        std::array<std::vector<char*>, kClasses> free_;
+        size_t live_count_;
+        size_t live_bytes_;
+        size_t reserved_bytes_;
+
+        /**
+         * @brief Номер класса участка для строки длины size
+         */
+        static size_t classOf(size_t size);
+
+        char* allocate(size_t size_class);
+
+    public:
+        StringArena();
+
+        StringArena(const StringArena&) = delete;
+        StringArena& operator=(const StringArena&) = delete;
+
+        /**
+         * @brief Скопировать строку в арену
+         * @return Представление копии, действительное до release() или clear()
+         */
+        std::string_view intern(std::string_view key);
+
+        /**
+         * @brief Вернуть участок строки, полученной из intern()
+         */
+        void release(std::string_view key);
+
+        /**
+         * @brief Освободить все строки и блоки
+         */
+        void clear();
+
+        size_t size()           const { return live_count_; }
+        size_t liveBytes()      const { return live_bytes_; }   ///< Суммарная длина живых строк
+        size_t reservedBytes()  const { return reserved_bytes_; }
+    };
+}
+
+#include "StringArena.tpp"
+
+#endif // STRINGARENA_H
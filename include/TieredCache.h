@@ -0,0 +1,107 @@
+/**
+ * @file TieredCache.h
+ * @brief Двухуровневый кэш: LFU в памяти поверх файлового уровня
+ */
+
+#ifndef TIEREDCACHE_H
+#define TIEREDCACHE_H
+
+#include <string>
+#include <functional>
+#include <chrono>
+
+#include "LFUCache.h"
+#include "DiskTier.h"
+#include "KeyPolicy.h"
+
+namespace tier
+{
+    /**
+     * @brief Двухуровневый кэш
+     * 
+     * @details Элемент, вытесненный из LFU кэша в памяти, переносится в файловый уровень.
+     * Промах в памяти сначала ищет значение в файле (и поднимает его обратно в память),
+     * и только потом обращается к медленному источнику. Элементы с истекшим TTL в файл
+     * не переносятся, у остальных вместе со значением сохраняется момент истечения: при подъеме
+     * TTL восстанавливается, а запись, срок которой истек в файле, считается промахом
+     * 
+     * @tparam K Тип ключа (тривиально копируемый)
+     * @tparam V Тип значения (тривиально копируемый)
+     * @tparam KeyPolicy Политика хранения ключей
+     */
+    template<typename K, typename V, typename KeyPolicy = keys::HashKeys>
+    class TieredCache
+    {
+    private:
+        using SlowGetFunc = std::function<V(const K&)>;
+
+        SlowGetFunc backend_;
+        DiskTier<K, V, KeyPolicy> disk_;
+        lfu::LFUCache<K, V, KeyPolicy> memory_;
+
+        size_t memory_hits_;
+        size_t disk_hits_;
+        size_t backend_loads_;
+        size_t demotions_;
+
+        /**
+         * @brief Оставшийся TTL значения, которое load() только что подняла из файла
+         */
+        std::chrono::milliseconds promoted_ttl_;
+
+        /**
+         * @brief Загрузчик для уровня в памяти: файл, затем медленный источник
+         */
+        V load(const K& key);
+
+    public:
+        /**
+         * @brief Конструктор
+         * @param memory_capacity Вместимость уровня в памяти >0
+         * @param disk_capacity Вместимость файлового уровня >0
+         * @param log_path Путь к журналу файлового уровня
+         * @param backend Функция для медленного получения значения
+         * 
+         * @throws StorageException если журнал не удалось создать
+         */
+        TieredCache(size_t memory_capacity, size_t disk_capacity, const std::string& log_path, SlowGetFunc backend);
+
+        ~TieredCache() noexcept = default;
+
+        TieredCache(const TieredCache&) = delete;
+        TieredCache& operator=(const TieredCache&) = delete;
+
+        /**
+         * @brief Получить значение с любого уровня, при необходимости загрузив его
+         * @param key Ключ
+         * @return Ссылка на значение в памяти
+         * 
+         * @throws StorageException если ошибка файлового уровня
+         */
+        V& get(const K& key);
+
+        /**
+         * @brief Задать TTL элементу в памяти (см. LFUCache::setTTL)
+         * @throws std::out_of_range если ключа нет в памяти
+         */
+        void setTTL(const K& key, std::chrono::milliseconds ttl) { memory_.setTTL(key, ttl); }
+
+        /**
+         * @brief Заменить источник времени для TTL (см. LFUCache::setClock)
+         */
+        void setClock(typename lfu::LFUCache<K, V, KeyPolicy>::Clock clock) { memory_.setClock(std::move(clock)); }
+
+        size_t memoryHits()     const { return memory_hits_; }
+        size_t diskHits()       const { return disk_hits_; }
+        size_t backendLoads()   const { return backend_loads_; }
+        size_t demotions()      const { return demotions_; }
+        size_t requests()       const { return memory_hits_ + disk_hits_ + backend_loads_; }
+
+        const lfu::LFUCache<K, V, KeyPolicy>& memory() const { return memory_; }
+        const DiskTier<K, V, KeyPolicy>& disk()        const { return disk_; }
+    };
+}
+
+#include "TieredCache.tpp"
+
+#endif // TIEREDCACHE_H
@@ -0,0 +1,163 @@
+/**
+ * @file Timeline.h
+ * @brief Поведение кэша во времени: статистика по окнам из W запросов
+ * @details Для каждого окна сохраняются попадания, промахи, вытеснения, заполненность и (для LFU)
+ * наименьшая частота и гистограмма частот. Данные хранятся по столбцам и выгружаются в CSV или
+ * в двоичный файл с сигнатурой LFUTLINE, где каждый столбец лежит непрерывно
+ */
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+
+#include "MappedFile.h"
+#include "exceptions/StorageException.h"
+
+namespace timeline
+{
+    /**
+     * @brief Число интервалов гистограммы частот: интервал b - частоты [2^b, 2^(b+1)), последний открыт
+     */
+    inline constexpr size_t kFrequencyBins = 16;
+
+    /**
+     * @brief Заголовок двоичного файла статистики
+     */
+    struct TimelineHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t frequency_bins;
+        uint64_t timelines;
+    };
+
+    /**
+     * @brief Заголовок одной политики, за ним имя и столбцы end, hits, misses, evictions, occupancy (uint64),
+     * min_frequency (int32) и, если has_frequencies, kFrequencyBins столбцов гистограммы (uint64)
+     */
+    struct TimelineRecordHeader
+    {
+        uint64_t window;
+        uint64_t rows;
+        uint32_t name_size;
+        uint32_t has_frequencies;
+    };
+
+    inline constexpr char     kTimelineMagic[8] = {'L', 'F', 'U', 'T', 'L', 'I', 'N', 'E'};
+    inline constexpr uint32_t kTimelineVersion  = 1;
+
+    /**
+     * @brief Номер интервала гистограммы для частоты >= 1
+     */
+    inline size_t frequencyBin(int frequency);
+
+    /**
+     * @brief Статистика одной политики по окнам, по столбцам
+     */
+    struct Timeline
+    {
+        std::string policy;
+        uint64_t window = 0;
+
+        std::vector<uint64_t> end;          ///< Число запросов с начала трассы на конец окна
+        std::vector<uint64_t> hits;
+        std::vector<uint64_t> misses;
+        std::vector<uint64_t> evictions;    ///< Промахи окна минус прирост заполненности
+        std::vector<uint64_t> occupancy;    ///< Число элементов на конец окна
+        std::vector<int32_t> min_frequency; ///< -1 если у политики нет частот или кэш пуст
+
+        /**
+         * @brief Гистограмма частот на конец окна (столбцы пусты, если у политики нет частот)
+         */
+        std::array<std::vector<uint64_t>, kFrequencyBins> frequency_bins;
+
+        size_t rows() const { return end.size(); }
+        bool hasFrequencies() const { return !frequency_bins[0].empty(); }
+        double hitRate(size_t row) const;
+    };
+
+    /**
+     * @brief Сборщик статистики по окнам
+     *
+     * @details На каждый запрос - счетчик и сравнение. Состояние кэша читается только на границе окна:
+     * size() (или getCurrentSize()) и, если у кэша есть forEachFrequency, обход списков частот
+     */
+    class Recorder
+    {
+    private:
+        Timeline timeline_;
+        uint64_t requests_;
+        uint64_t window_requests_;
+        uint64_t window_hits_;
+        uint64_t last_occupancy_;
+
+        template<typename Cache>
+        void sample(const Cache& cache);
+
+    public:
+        /**
+         * @brief Конструктор
+         * @param policy Имя политики для выгрузки
+         * @param window Длина окна в запросах >0
+         *
+         * @throws std::invalid_argument если window == 0
+         */
+        Recorder(std::string policy, size_t window);
+
+        /**
+         * @brief Учесть запрос (вызывается после того, как кэш его обработал)
+         */
+        template<typename Cache>
+        void access(bool hit, const Cache& cache)
+        {
+            requests_++;
+            window_hits_ += hit ? 1 : 0;
+            if (++window_requests_ == timeline_.window)
+            {
+                sample(cache);
+            }
+        }
+
+        /**
+         * @brief Закрыть неполное последнее окно
+         */
+        template<typename Cache>
+        void finish(const Cache& cache);
+
+        const Timeline& timeline() const { return timeline_; }
+    };
+
+    /**
+     * @brief Записать статистику в CSV: по строке на окно каждой политики
+     * @throws StorageException если запись не удалась
+     */
+    void writeCsv(const std::string& path, const std::vector<Timeline>& timelines);
+
+    /**
+     * @brief Записать статистику в двоичный столбцовый формат
+     * @throws StorageException если запись не удалась
+     */
+    void writeBinary(const std::string& path, const std::vector<Timeline>& timelines);
+
+    /**
+     * @brief Прочитать двоичный файл статистики
+     * @throws StorageException если файл поврежден
+     */
+    std::vector<Timeline> readBinary(const std::string& path);
+
+    /**
+     * @brief Записать в CSV, если путь оканчивается на .csv, иначе в двоичный формат
+     */
+    void write(const std::string& path, const std::vector<Timeline>& timelines);
+}
+
+#include "Timeline.tpp"
+
+#endif // TIMELINE_H
@@ -0,0 +1,112 @@
+/**
+ * @file TimingWheel.h
+ * @brief Иерархическое колесо таймеров для истечения срока жизни элементов
+ */
+
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include <array>
+#include <list>
+#include <cstdint>
+#include <cstddef>
+
+namespace timer
+{
+    /**
+     * @brief Иерархическое колесо таймеров
+     * 
+     * @details 4 уровня по 64 слота, уровень L покрывает интервалы в 64^L тиков. Таймер кладется
+     * на уровень по расстоянию до срока и спускается на нижние уровни при переходе границ,
+     * поэтому постановка, отмена и срабатывание стоят O(1) в среднем, без просмотра всех таймеров.
+     * Сроки дальше 64^4 тиков ставятся на верхний уровень и перекладываются при каждом спуске
+     * 
+     * @tparam K Тип ключа, который возвращается при срабатывании
+     */
+    template<typename K>
+    class TimingWheel
+    {
+    public:
+        static constexpr unsigned kLevelBits = 6;
+        static constexpr size_t   kSlots     = size_t(1) << kLevelBits;
+        static constexpr size_t   kLevels    = 4;
+
+        /**
+         * @brief Таймер: ключ, абсолютный срок в тиках и текущее место в колесе
+         */
+        struct Timer
+        {
+            K key;
+            uint64_t expire;
+            uint8_t level;
+            uint8_t slot;
+        };
+
+        using Handle = typename std::list<Timer>::iterator;
+
+    private:
+        std::array<std::array<std::list<Timer>, kSlots>, kLevels> wheels_;
+        std::array<size_t, kLevels> level_sizes_;
+        uint64_t now_;
+        size_t size_;
+
+        /**
+         * @brief Куда положить таймер относительно now_
+         * @param earliest Самый ранний тик, слот которого еще будет разобран
+         */
+        void target(uint64_t expire, uint64_t earliest, uint8_t& level, uint8_t& slot) const;
+
+        /**
+         * @brief Переложить таймер из его текущего слота в слот по сроку
+         */
+        void place(Handle handle, uint64_t earliest);
+
+        /**
+         * @brief Разложить таймеры слота по нижним уровням
+         */
+        void cascade(size_t level, size_t slot);
+
+    public:
+        /**
+         * @brief Конструктор
+         * @param now Текущий тик
+         */
+        explicit TimingWheel(uint64_t now = 0);
+
+        /**
+         * @brief Поставить таймер
+         * @param key Ключ
+         * @param expire Абсолютный срок в тиках (прошедший срок сработает на следующем тике)
+         * @return Описатель для отмены
+         */
+        Handle schedule(const K& key, uint64_t expire);
+
+        /**
+         * @brief Отменить таймер
+         * @param handle Описатель, полученный от schedule и еще не сработавший
+         */
+        void cancel(Handle handle);
+
+        /**
+         * @brief Продвинуть время и вызвать on_expire(key) для каждого истекшего таймера
+         * @param now Новый текущий тик (меньшие значения игнорируются)
+         * @param on_expire Обработчик, таймер уже удален из колеса на момент вызова
+         * @return Число сработавших таймеров
+         */
+        template<typename OnExpire>
+        size_t advance(uint64_t now, OnExpire&& on_expire);
+
+        /**
+         * @brief Удалить все таймеры
+         */
+        void clear();
+
+        uint64_t now()  const { return now_; }
+        size_t size()   const { return size_; }
+        bool empty()    const { return size_ == 0; }
+    };
+}
+
+#include "TimingWheel.tpp"
+
+#endif // TIMINGWHEEL_H
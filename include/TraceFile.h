@@ -0,0 +1,138 @@
+/**
+ * @file TraceFile.h
+ * @brief Чтение и запись последовательностей запросов (трасс) в файл
+ * @details Двоичный формат: заголовок с сигнатурой LFUTRACE и числом записей, затем ключи int32.
+ * Текстовый формат: целые числа через пробельные символы. Формат при чтении определяется по сигнатуре
+ */
+
+#ifndef TRACEFILE_H
+#define TRACEFILE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#include "MappedFile.h"
+#include "exceptions/StorageException.h"
+
+namespace trace
+{
+    /**
+     * @brief Заголовок двоичной трассы
+     */
+    struct TraceHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t key_size;
+        uint64_t count;
+        uint64_t reserved;
+    };
+
+    inline constexpr char     kTraceMagic[8] = {'L', 'F', 'U', 'T', 'R', 'A', 'C', 'E'};
+    inline constexpr uint32_t kTraceVersion  = 1;
+
+    /**
+     * @brief Потоковая запись трассы
+     * @details Ключи копятся в буфере, число записей дописывается в заголовок при close()
+     */
+    class TraceWriter
+    {
+    private:
+        std::ofstream out_;
+        std::string path_;
+        bool text_;
+        uint64_t count_;
+        std::vector<int32_t> buffer_;
+
+        void flushBuffer();
+
+    public:
+        /**
+         * @brief Открыть файл на запись
+         * @param path Путь к файлу
+         * @param text Писать текстовый формат вместо двоичного
+         * 
+         * @throws StorageException если файл не удалось открыть
+         */
+        explicit TraceWriter(const std::string& path, bool text = false);
+
+        /**
+         * @brief Закрывает файл, если close() не был вызван (ошибки при этом не сообщаются)
+         */
+        ~TraceWriter() noexcept;
+
+        TraceWriter(const TraceWriter&) = delete;
+        TraceWriter& operator=(const TraceWriter&) = delete;
+
+        void write(int32_t key);
+        void write(const std::vector<int>& keys);
+
+        /**
+         * @brief Дописать буфер и заголовок
+         * @throws StorageException если запись не удалась
+         */
+        void close();
+
+        uint64_t count() const { return count_; }
+    };
+
+    /**
+     * @brief Потоковое чтение трассы порциями
+     * @details Двоичная трасса отображается через mmap, текстовая читается из потока
+     */
+    class TraceReader
+    {
+    private:
+        std::unique_ptr<storage::MappedFile> file_;
+        std::ifstream text_;
+        std::string path_;
+        uint64_t count_;
+        uint64_t offset_;
+
+    public:
+        /**
+         * @brief Открыть трассу
+         * @param path Путь к файлу
+         * 
+         * @throws StorageException если файл не удалось открыть или двоичная трасса повреждена
+         */
+        explicit TraceReader(const std::string& path);
+
+        /**
+         * @brief Прочитать следующую порцию
+         * @param chunk Заменяется прочитанными ключами
+         * @param max_size Наибольший размер порции
+         * @return Число прочитанных ключей (0 - конец трассы)
+         * 
+         * @throws StorageException если в текстовой трассе встретилось не число
+         */
+        size_t read(std::vector<int>& chunk, size_t max_size);
+
+        bool binary() const { return file_ != nullptr; }
+
+        /**
+         * @brief Число записей (известно заранее только для двоичной трассы, иначе 0)
+         */
+        uint64_t count() const { return count_; }
+    };
+
+    /**
+     * @brief Прочитать трассу целиком
+     * @throws StorageException если ошибка чтения
+     */
+    std::vector<int> readTrace(const std::string& path);
+
+    /**
+     * @brief Записать трассу целиком
+     * @throws StorageException если ошибка записи
+     */
+    void writeTrace(const std::string& path, const std::vector<int>& requests, bool text = false);
+}
+
+#include "TraceFile.tpp"
+
+#endif // TRACEFILE_H
@@ -0,0 +1,290 @@
+/**
+ * @file TraceStats.h
+ * @brief Потоковые оценки свойств трассы: число различных ключей, популярность, расстояния повторного
+ * использования и рабочее множество
+ * @details Все структуры работают за один проход и в ограниченной памяти. HyperLogLog и Space-Saving
+ * объединяются, поэтому их можно считать параллельно по частям трассы
+ */
+
+#ifndef TRACESTATS_H
+#define TRACESTATS_H
+
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+#include "Shards.h"
+#include "exceptions/ConfigurationException.h"
+
+namespace stats
+{
+    /**
+     * @brief Оценка числа различных ключей (HyperLogLog)
+     * 
+     * @tparam K Тип ключа (должен поддерживать std::hash)
+     */
+    template<typename K>
+    class HyperLogLog
+    {
+    private:
+        unsigned precision_;
+        std::vector<uint8_t> registers_;
+
+    public:
+        /**
+         * @brief Конструктор
+         * @param precision Число бит индекса регистра, [4, 18]: 2^precision регистров
+         * 
+         * @throws ConfigurationException если precision вне диапазона
+         */
+        explicit HyperLogLog(unsigned precision = 14);
+
+        void add(const K& key);
+
+        /**
+         * @brief Объединить с оценкой другой части трассы
+         * @throws ConfigurationException если точности различаются
+         */
+        void merge(const HyperLogLog& other);
+
+        double estimate() const;
+
+        /**
+         * @brief Стандартная относительная ошибка 1.04 / sqrt(m)
+         */
+        double relativeError() const;
+    };
+
+    /**
+     * @brief Счетчики самых частых ключей (Space-Saving)
+     * @details Хранит capacity счетчиков в min-куче. Для каждого ключа count - оценка сверху,
+     * count - error - оценка снизу числа обращений
+     * 
+     * @tparam K Тип ключа
+     */
+    template<typename K>
+    class SpaceSaving
+    {
+    public:
+        struct Counter
+        {
+            K key;
+            uint64_t count;
+            uint64_t error;
+        };
+
+    private:
+        size_t capacity_;
+        std::vector<Counter> heap_;
+        std::unordered_map<K, size_t> index_;
+
+        void swapNodes(size_t a, size_t b);
+        void siftUp(size_t i);
+        void siftDown(size_t i);
+
+    public:
+        /**
+         * @brief Конструктор
+         * @param capacity Число счетчиков >0
+         * 
+         * @throws ConfigurationException если capacity == 0
+         */
+        explicit SpaceSaving(size_t capacity = 1024);
+
+        void add(const K& key);
+
+        /**
+         * @brief Объединить с результатом другой части трассы (объединяемые сводки Agarwal et al.)
+         */
+        void merge(const SpaceSaving& other);
+
+        /**
+         * @brief Счетчики по убыванию count
+         */
+        std::vector<Counter> top() const;
+
+        /**
+         * @brief Гарантированные частоты верхних рангов, пока ошибка меньше половины счетчика
+         * @details Ниже этой границы счетчики почти целиком состоят из ошибки и для оценки распределения не годятся
+         */
+        std::vector<uint64_t> reliableCounts() const;
+
+        /**
+         * @brief Наименьший счетчик (0 пока сводка не заполнена)
+         */
+        uint64_t minCount() const;
+
+        size_t capacity() const { return capacity_; }
+    };
+
+    /**
+     * @brief Оценка показателя Zipf по частотам в порядке убывания
+     * @param counts Частоты ранжированных ключей (по убыванию)
+     * @return alpha из регрессии log(count) = c - alpha * log(rank) или 0, если точек меньше двух
+     */
+    double fitZipf(const std::vector<uint64_t>& counts);
+
+    /**
+     * @brief Дерево Фенвика над int64 для префиксных сумм
+     */
+    class FenwickTree
+    {
+    private:
+        std::vector<int64_t> tree_;
+
+    public:
+        explicit FenwickTree(size_t size = 0) : tree_(size + 1, 0) {}
+
+        size_t size() const { return tree_.size() - 1; }
+
+        void add(size_t index, int64_t delta);
+
+        /**
+         * @brief Сумма элементов [0, end)
+         */
+        int64_t prefix(size_t end) const;
+
+        /**
+         * @brief Сумма элементов [begin, end)
+         */
+        int64_t range(size_t begin, size_t end) const { return prefix(end) - prefix(begin); }
+
+        /**
+         * @brief Построить дерево по массиву значений за O(n)
+         */
+        void assign(const std::vector<int64_t>& values);
+    };
+
+    /**
+     * @brief Параметры профиля повторного использования
+     */
+    struct ReuseOptions
+    {
+        double rate = 1.0;                      ///< Начальная доля ключей в выборке
+        size_t max_tracked = 1 << 20;           ///< Наибольшее число ключей в выборке (доля уменьшается при превышении)
+        std::vector<uint64_t> windows = {1000, 10000, 100000, 1000000};
+        uint64_t seed = 0;
+        size_t initial_positions = 1 << 16;     ///< Начальный размер дерева Фенвика
+    };
+
+    /**
+     * @brief Расстояния повторного использования и рабочее множество по пространственной выборке ключей
+     * 
+     * @details Каждому обращению к ключу выборки дается позиция, дерево Фенвика хранит единицу
+     * в позиции последнего обращения к каждому ключу. Расстояние (число различных ключей между
+     * обращениями) - сумма по диапазону позиций, O(log N). Когда позиции кончаются, живые позиции
+     * перенумеровываются по порядку. Если выборка превышает max_tracked, порог выборки снижается
+     * и ключи с наибольшими значениями хеша удаляются (SHARDS с фиксированным размером), поэтому
+     * память ограничена. Оценки масштабируются на 1 / rate
+     * 
+     * @tparam K Тип ключа (должен поддерживать std::hash)
+     */
+    template<typename K>
+    class ReuseProfiler
+    {
+    public:
+        /**
+         * @brief Размер рабочего множества для окна
+         */
+        struct WindowStats
+        {
+            uint64_t window;
+            double mean;
+            double max;
+        };
+
+    private:
+        struct Entry
+        {
+            size_t position;
+            uint64_t references;
+        };
+
+        static constexpr uint64_t kModulus = 1ULL << 24;
+
+        ReuseOptions options_;
+        uint64_t seed_;
+        uint64_t threshold_;
+
+        std::unordered_map<K, Entry> tracked_;
+        std::priority_queue<std::pair<uint64_t, K>> by_slot_;
+
+        FenwickTree marks_;
+        std::vector<uint64_t> position_time_;
+        size_t cursor_;
+        size_t compactions_;
+
+        std::vector<double> histogram_;
+        double cold_;
+        double references_;
+
+        std::vector<double> window_sum_;
+        std::vector<double> window_max_;
+        double window_weight_;
+
+        uint64_t slotOf(const K& key) const;
+        void compact();
+        void shrinkSample();
+
+    public:
+        /**
+         * @brief Конструктор
+         * @throws ConfigurationException если параметры некорректны
+         */
+        explicit ReuseProfiler(ReuseOptions options = ReuseOptions());
+
+        /**
+         * @brief Учесть обращение
+         * @param key Ключ
+         * @param time Номер обращения в полной трассе (не убывает)
+         */
+        void access(const K& key, uint64_t time);
+
+        /**
+         * @brief Текущая доля выборки
+         */
+        double rate() const { return static_cast<double>(threshold_) / static_cast<double>(kModulus); }
+
+        /**
+         * @brief Номер корзины гистограммы для расстояния: 0 - для 0, b - для [2^(b-1), 2^b)
+         */
+        static size_t binOf(double distance);
+
+        /**
+         * @brief Оценка числа обращений по корзинам расстояний (без первых обращений)
+         */
+        const std::vector<double>& histogram() const { return histogram_; }
+
+        /**
+         * @brief Оценка числа первых обращений к ключам
+         */
+        double coldMisses() const { return cold_; }
+
+        /**
+         * @brief Оценка общего числа обращений
+         */
+        double references() const { return references_; }
+
+        /**
+         * @brief Доля ключей выборки, к которым обратились ровно один раз
+         */
+        double oneHitFraction() const;
+
+        /**
+         * @brief Рабочее множество (различные ключи за последние W обращений) для каждого окна
+         * @details Замеры делаются в моменты обращений к ключам выборки, среднее взвешено на 1 / rate
+         * в момент замера, поэтому периоды с разной долей выборки учитываются пропорционально длине
+         */
+        std::vector<WindowStats> workingSets() const;
+
+        size_t trackedKeys() const { return tracked_.size(); }
+        size_t compactions() const { return compactions_; }
+    };
+}
+
+#include "TraceStats.tpp"
+
+#endif // TRACESTATS_H
@@ -0,0 +1,145 @@
+/**
+ * @file WriteBackBuffer.h
+ * @brief Отложенная пакетная запись измененных элементов, вытесненных из кэша
+ */
+
+#ifndef WRITEBACKBUFFER_H
+#define WRITEBACKBUFFER_H
+
+#include <unordered_map>
+#include <vector>
+#include <list>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <exception>
+#include <optional>
+
+#include "EvictionListener.h"
+#include "exceptions/ConfigurationException.h"
+
+namespace lfu
+{
+    /**
+     * @brief Буфер отложенной записи
+     * 
+     * @details Получает уведомления о вытеснении и накапливает только измененные элементы.
+     * Фоновый поток передает их источнику пачками: когда набралось batch_size элементов
+     * или когда самый старый ждет дольше flush_deadline. Повторное вытеснение ключа до записи
+     * заменяет значение в буфере, поэтому источник получает одну запись на ключ
+     * 
+     * @tparam K Тип ключа
+     * @tparam V Тип значения
+     */
+    template<typename K, typename V>
+    class WriteBackBuffer : public EvictionListener<K, V>
+    {
+    public:
+        using Batch = std::vector<std::pair<K, V>>;
+        using BatchWriter = std::function<void(const Batch&)>;
+        using Clock = std::chrono::steady_clock;
+
+    private:
+        BatchWriter writer_;
+        size_t batch_size_;
+        Clock::duration flush_deadline_;
+
+        std::mutex mutex_;
+        std::condition_variable work_cv_;
+        std::condition_variable idle_cv_;
+
+        /**
+         * @brief Элемент буфера и момент, с которого он ждет записи
+         */
+        struct Pending
+        {
+            K key;
+            V value;
+            Clock::time_point enqueued;
+        };
+
+        /**
+         * @brief Буфер в порядке поступления: пачка берется с начала, срок считается по первому элементу
+         */
+        std::list<Pending> pending_;
+        std::unordered_map<K, typename std::list<Pending>::iterator> pending_index_;
+
+        /**
+         * @brief Пачка, которую сейчас записывает фоновый поток, и позиции ее ключей
+         */
+        Batch in_flight_;
+        std::unordered_map<K, size_t> in_flight_index_;
+
+        bool writing_;
+        bool flush_requested_;
+        bool stop_;
+        std::exception_ptr error_;
+
+        size_t batches_written_;
+        size_t entries_written_;
+        size_t coalesced_;
+
+        std::thread worker_;
+
+        /**
+         * @brief Цикл фонового потока
+         */
+        void run();
+
+        /**
+         * @brief Забрать до batch_size самых старых элементов из буфера в in_flight_ (вызывается под блокировкой)
+         */
+        void takeBatch();
+
+    public:
+        /**
+         * @brief Конструктор, запускает фоновый поток
+         * @param writer Запись пачки в источник (вызывается из фонового потока)
+         * @param batch_size Размер пачки >0
+         * @param flush_deadline Максимальное время ожидания элемента в буфере
+         * 
+         * @throws ConfigurationException если batch_size == 0
+         */
+        WriteBackBuffer(BatchWriter writer, size_t batch_size, Clock::duration flush_deadline);
+
+        /**
+         * @brief Записывает оставшиеся элементы и останавливает поток
+         */
+        ~WriteBackBuffer() noexcept override;
+
+        WriteBackBuffer(const WriteBackBuffer&) = delete;
+        WriteBackBuffer& operator=(const WriteBackBuffer&) = delete;
+
+        void onEvict(const K& key, const V& value, bool dirty) override;
+
+        /**
+         * @brief Значение ключа, ожидающее записи или записываемое сейчас
+         * @details LFUCache вызывает его перед загрузкой, поэтому промах по недавно вытесненному
+         * измененному ключу возвращает это значение, а не устаревшее из источника
+         * @return Значение или std::nullopt, если ключа нет ни в буфере, ни в записываемой пачке
+         */
+        std::optional<V> lookup(const K& key) override;
+
+        /**
+         * @brief Записать все накопленные элементы и дождаться окончания записи, в том числе уже начатой
+         * 
+         * @throws любое исключение, брошенное writer в фоновом потоке
+         */
+        void flush();
+
+        size_t pendingCount();
+        size_t batchesWritten();
+        size_t entriesWritten();
+
+        /**
+         * @brief Сколько записей сэкономлено объединением повторных вытеснений ключа
+         */
+        size_t coalescedCount();
+    };
+}
+
+#include "WriteBackBuffer.tpp"
+
+#endif // WRITEBACKBUFFER_H
@@ -0,0 +1,22 @@
+/**
+ * @file StorageException.h
+ * @brief Исключение для ошибок работы с файлами (снимки, дисковые уровни)
+ */
+
+#ifndef STORAGEEXCEPTION_H
+#define STORAGEEXCEPTION_H
+
+#include "CacheException.h"
+#include <string>
+
+class StorageException : public CacheException
+{
+public:
+
+    explicit StorageException(const std::string& message) 
+        : CacheException("Storage error: " + message) {}
+    
+    virtual ~StorageException() noexcept = default;
+};
+
+#endif // STORAGEEXCEPTION_H
@@ -0,0 +1,248 @@
+/**
+ * @file CompactLFUCache.tpp
+ * @brief Реализация плотного LFU кэша
+ */
+
+#ifndef COMPACTLFUCACHE_TPP
+#define COMPACTLFUCACHE_TPP
+
+#include "CompactLFUCache.h"
+#include <algorithm>
+
+template<typename K, typename V, typename Hash>
+lfu::CompactLFUCache<K, V, Hash>::CompactLFUCache(size_t capacity, SlowGetFunc slow_get_func)
+    : capacity_(capacity), slow_get_func_(std::move(slow_get_func)), free_head_(kNone), size_(0), min_frequency_(0)
+{
+    if (capacity_ == 0)
+    {
+        throw std::invalid_argument("Cache capacity must be greater than 0");
+    }
+    if (capacity_ >= (size_t{1} << 31))
+    {
+        throw std::invalid_argument("Compact cache capacity must be below 2^31");
+    }
+
+    size_t slots = 16;
+    while (slots < 2 * capacity_)
+    {
+        slots <<= 1;
+    }
+    slots_.assign(slots, 0);
+    slot_mask_ = slots - 1;
+    heads_.fill(kNone);
+}
+
+template<typename K, typename V, typename Hash>
+size_t lfu::CompactLFUCache<K, V, Hash>::slotOf(const K& key) const
+{
+    // std::hash для целых - тождественная функция, без перемешивания соседние ключи шли бы подряд
+    uint64_t h = static_cast<uint64_t>(hash_(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h) & slot_mask_;
+}
+
+template<typename K, typename V, typename Hash>
+size_t lfu::CompactLFUCache<K, V, Hash>::probe(const K& key) const
+{
+    size_t slot = slotOf(key);
+    while (slots_[slot] != 0 && !(nodes_[slots_[slot] - 1].key == key))
+    {
+        slot = (slot + 1) & slot_mask_;
+    }
+    return slot;
+}
+
+template<typename K, typename V, typename Hash>
+void lfu::CompactLFUCache<K, V, Hash>::eraseSlot(size_t slot)
+{
+    // сдвиг назад: элементы цепочки, которым дыра по пути от их начальной ячейки, переезжают в нее
+    size_t hole = slot;
+    slots_[hole] = 0;
+    for (size_t next = (hole + 1) & slot_mask_; slots_[next] != 0; next = (next + 1) & slot_mask_)
+    {
+        size_t home = slotOf(nodes_[slots_[next] - 1].key);
+        if (((next - home) & slot_mask_) >= ((next - hole) & slot_mask_))
+        {
+            slots_[hole] = slots_[next];
+            slots_[next] = 0;
+            hole = next;
+        }
+    }
+}
+
+template<typename K, typename V, typename Hash>
+void lfu::CompactLFUCache<K, V, Hash>::link(Index node, int frequency)
+{
+    Node& n = nodes_[node];
+    n.frequency = static_cast<uint8_t>(frequency);
+
+    Index head = heads_[frequency];
+    if (head == kNone)
+    {
+        n.prev = node;
+        n.next = node;
+    }
+    else
+    {
+        Index tail = nodes_[head].prev;
+        n.next = head;
+        n.prev = tail;
+        nodes_[tail].next = node;
+        nodes_[head].prev = node;
+    }
+    heads_[frequency] = node;
+}
+
+template<typename K, typename V, typename Hash>
+void lfu::CompactLFUCache<K, V, Hash>::unlink(Index node)
+{
+    Node& n = nodes_[node];
+    if (n.next == node)
+    {
+        heads_[n.frequency] = kNone;
+        return;
+    }
+
+    nodes_[n.prev].next = n.next;
+    nodes_[n.next].prev = n.prev;
+    if (heads_[n.frequency] == node)
+    {
+        heads_[n.frequency] = n.next;
+    }
+}
+
+template<typename K, typename V, typename Hash>
+void lfu::CompactLFUCache<K, V, Hash>::touch(Index node)
+{
+    int frequency = nodes_[node].frequency;
+    unlink(node);
+
+    if (frequency == kMaxFrequency)
+    {
+        link(node, frequency);
+        return;
+    }
+
+    if (heads_[frequency] == kNone && min_frequency_ == frequency)
+    {
+        min_frequency_++;
+    }
+    link(node, frequency + 1);
+}
+
+template<typename K, typename V, typename Hash>
+typename lfu::CompactLFUCache<K, V, Hash>::Index lfu::CompactLFUCache<K, V, Hash>::allocateNode(const K& key, V value)
+{
+    if (free_head_ != kNone)
+    {
+        Index node = free_head_;
+        free_head_ = nodes_[node].next;
+        nodes_[node].key = key;
+        nodes_[node].value = std::move(value);
+        return node;
+    }
+
+    if (nodes_.size() == nodes_.capacity())
+    {
+        // рост массива не выходит за вместимость кэша
+        nodes_.reserve(std::min(capacity_, std::max<size_t>(16, 2 * nodes_.size())));
+    }
+    nodes_.push_back(Node{key, std::move(value), kNone, kNone, 0});
+    return static_cast<Index>(nodes_.size() - 1);
+}
+
+template<typename K, typename V, typename Hash>
+V& lfu::CompactLFUCache<K, V, Hash>::get(const K& key)
+{
+    Index stored = slots_[probe(key)];
+    if (stored == 0)
+    {
+        throw std::out_of_range("Key not found");
+    }
+
+    touch(stored - 1);
+    return nodes_[stored - 1].value;
+}
+
+template<typename K, typename V, typename Hash>
+V& lfu::CompactLFUCache<K, V, Hash>::put(const K& key)
+{
+    size_t slot = probe(key);
+    if (slots_[slot] != 0)
+    {
+        Index node = slots_[slot] - 1;
+        nodes_[node].value = slow_get_func_(key);
+        touch(node);
+        return nodes_[node].value;
+    }
+
+    V value = slow_get_func_(key);
+    if (size_ >= capacity_)
+    {
+        evict();
+        slot = probe(key);
+    }
+
+    Index node = allocateNode(key, std::move(value));
+    slots_[slot] = node + 1;
+    link(node, 1);
+    min_frequency_ = 1;
+    size_++;
+    return nodes_[node].value;
+}
+
+template<typename K, typename V, typename Hash>
+std::pair<K, V> lfu::CompactLFUCache<K, V, Hash>::evict()
+{
+    if (empty())
+    {
+        throw CacheOperationException("Cannot evict from empty cache");
+    }
+
+    while (heads_[min_frequency_] == kNone)
+    {
+        min_frequency_++;
+    }
+
+    Index victim = nodes_[heads_[min_frequency_]].prev;
+    eraseSlot(probe(nodes_[victim].key));
+    unlink(victim);
+
+    std::pair<K, V> result(std::move(nodes_[victim].key), std::move(nodes_[victim].value));
+    nodes_[victim].next = free_head_;
+    free_head_ = victim;
+    size_--;
+    return result;
+}
+
+template<typename K, typename V, typename Hash>
+int lfu::CompactLFUCache<K, V, Hash>::frequencyOf(const K& key) const
+{
+    Index stored = slots_[probe(key)];
+    if (stored == 0)
+    {
+        throw std::out_of_range("Key not found");
+    }
+    return nodes_[stored - 1].frequency;
+}
+
+template<typename K, typename V, typename Hash>
+size_t lfu::CompactLFUCache<K, V, Hash>::memoryUsage() const
+{
+    return sizeof(*this) + nodes_.capacity() * sizeof(Node) + slots_.capacity() * sizeof(Index);
+}
+
+template<typename K, typename V, typename Hash>
+void lfu::CompactLFUCache<K, V, Hash>::clear()
+{
+    nodes_.clear();
+    std::fill(slots_.begin(), slots_.end(), 0);
+    heads_.fill(kNone);
+    free_head_ = kNone;
+    size_ = 0;
+    min_frequency_ = 0;
+}
+
+#endif // COMPACTLFUCACHE_TPP
@@ -0,0 +1,220 @@
+/**
+ * @file DiskTier.tpp
+ * @brief Реализация файлового уровня кэша
+ */
+
+#ifndef DISKTIER_TPP
+#define DISKTIER_TPP
+
+#include "DiskTier.h"
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+template<typename K, typename V, typename KeyPolicy>
+tier::DiskTier<K, V, KeyPolicy>::DiskTier(const std::string& path, size_t capacity)
+    : path_(path), fd_(-1), capacity_(capacity), flushed_records_(0), dropped_(0), compactions_(0)
+{
+    if (capacity_ == 0)
+    {
+        throw std::invalid_argument("Disk tier capacity must be greater than 0");
+    }
+
+    openLog(path_, O_RDWR | O_CREAT | O_TRUNC);
+    pending_.reserve(kWriteBatch);
+}
+
+template<typename K, typename V, typename KeyPolicy>
+tier::DiskTier<K, V, KeyPolicy>::~DiskTier() noexcept
+{
+    map_.reset();
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+    }
+    ::unlink(path_.c_str());
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void tier::DiskTier<K, V, KeyPolicy>::openLog(const std::string& path, int flags)
+{
+    fd_ = ::open(path.c_str(), flags | O_APPEND, 0644);
+    if (fd_ < 0)
+    {
+        throw StorageException("Cannot open disk tier log " + path + ": " + std::strerror(errno));
+    }
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void tier::DiskTier<K, V, KeyPolicy>::writeRecords(const Record* records, size_t count)
+{
+    const char* data = reinterpret_cast<const char*>(records);
+    size_t left = count * sizeof(Record);
+
+    while (left > 0)
+    {
+        ssize_t written = ::write(fd_, data, left);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw StorageException("Failed to append to " + path_ + ": " + std::strerror(errno));
+        }
+        data += written;
+        left -= static_cast<size_t>(written);
+    }
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void tier::DiskTier<K, V, KeyPolicy>::flush()
+{
+    if (pending_.empty())
+    {
+        return;
+    }
+
+    writeRecords(pending_.data(), pending_.size());
+    flushed_records_ += pending_.size();
+    pending_.clear();
+}
+
+template<typename K, typename V, typename KeyPolicy>
+typename tier::DiskTier<K, V, KeyPolicy>::Record tier::DiskTier<K, V, KeyPolicy>::readRecord(uint64_t number)
+{
+    if (number >= flushed_records_)
+    {
+        return pending_[number - flushed_records_];
+    }
+
+    const size_t end = (number + 1) * sizeof(Record);
+    if (!map_ || map_->size() < end)
+    {
+        map_.reset();
+        map_ = std::make_unique<storage::MappedFile>(path_, false);
+        if (map_->size() < end)
+        {
+            throw StorageException("Disk tier log is shorter than its index: " + path_);
+        }
+    }
+
+    Record record;
+    std::memcpy(&record, map_->data() + number * sizeof(Record), sizeof(Record));
+    return record;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void tier::DiskTier<K, V, KeyPolicy>::put(const K& key, const V& value, uint64_t expire)
+{
+    Record record;
+    std::memset(&record, 0, sizeof(record));
+    record.key = key;
+    record.value = value;
+    record.expire = expire;
+
+    uint64_t number = logRecords();
+    pending_.push_back(record);
+    index_[key] = number;
+    order_.emplace_back(key, number);
+
+    if (pending_.size() >= kWriteBatch)
+    {
+        flush();
+    }
+
+    dropOldest();
+    maybeCompact();
+}
+
+template<typename K, typename V, typename KeyPolicy>
+bool tier::DiskTier<K, V, KeyPolicy>::take(const K& key, V& value, uint64_t* expire)
+{
+    auto it = index_.find(key);
+    if (it == index_.end())
+    {
+        return false;
+    }
+
+    Record record = readRecord(it->second);
+    value = record.value;
+    if (expire != nullptr)
+    {
+        *expire = record.expire;
+    }
+    index_.erase(it);
+    return true;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void tier::DiskTier<K, V, KeyPolicy>::dropOldest()
+{
+    while (index_.size() > capacity_ && !order_.empty())
+    {
+        auto [key, number] = order_.front();
+        order_.pop_front();
+
+        auto it = index_.find(key);
+        if (it != index_.end() && it->second == number)
+        {
+            index_.erase(it);
+            dropped_++;
+        }
+    }
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void tier::DiskTier<K, V, KeyPolicy>::maybeCompact()
+{
+    const uint64_t live = index_.size();
+    if (logRecords() >= kMinCompactRecords && logRecords() > 2 * live)
+    {
+        compact();
+    }
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void tier::DiskTier<K, V, KeyPolicy>::compact()
+{
+    flush();
+
+    std::vector<Record> live;
+    live.reserve(index_.size());
+    std::deque<std::pair<K, uint64_t>> order;
+
+    for (const auto& [key, number] : order_)
+    {
+        auto it = index_.find(key);
+        if (it != index_.end() && it->second == number)
+        {
+            live.push_back(readRecord(number));
+            order.emplace_back(key, live.size() - 1);
+        }
+    }
+
+    const std::string tmp_path = path_ + ".compact";
+    map_.reset();
+    ::close(fd_);
+    fd_ = -1;
+
+    openLog(tmp_path, O_RDWR | O_CREAT | O_TRUNC);
+    writeRecords(live.data(), live.size());
+
+    if (std::rename(tmp_path.c_str(), path_.c_str()) != 0)
+    {
+        throw StorageException("Cannot replace disk tier log " + path_ + ": " + std::strerror(errno));
+    }
+
+    for (const auto& [key, number] : order)
+    {
+        index_[key] = number;
+    }
+    order_ = std::move(order);
+    flushed_records_ = live.size();
+    compactions_++;
+}
+
+#endif // DISKTIER_TPP
@@ -0,0 +1,144 @@
+/**
+ * @file GDSFCache.tpp
+ * @brief Реализация GDSF кэша
+ */
+
+#ifndef GDSFCACHE_TPP
+#define GDSFCACHE_TPP
+
+#include "GDSFCache.h"
+#include <algorithm>
+
+template<typename K, typename V, typename KeyPolicy>
+lfu::GDSFCache<K, V, KeyPolicy>::GDSFCache(size_t capacity, SlowGetFunc slow_get_func)
+    : capacity_(capacity), slow_get_func_(std::move(slow_get_func)),
+      clock_([]() {
+          return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now().time_since_epoch()).count());
+      }),
+      inflation_(0), miss_cost_(0), load_count_(0)
+{
+    if (capacity_ == 0)
+    {
+        throw std::invalid_argument("Cache capacity must be greater than 0");
+    }
+}
+
+template<typename K, typename V, typename KeyPolicy>
+V lfu::GDSFCache<K, V, KeyPolicy>::load(const K& key, uint64_t& cost)
+{
+    uint64_t start = clock_();
+    V value = slow_get_func_(key);
+    uint64_t end = clock_();
+
+    cost = std::max<uint64_t>(1, end - start);
+    miss_cost_ += cost;
+    load_count_++;
+    return value;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lfu::GDSFCache<K, V, KeyPolicy>::reposition(NodeIterator it)
+{
+    auto bucket = priority_map_.find(it->priority);
+    it->priority = inflation_ + static_cast<uint64_t>(it->frequency) * it->cost;
+
+    // узел переносится без копирования, итератор в key_map_ остается валидным
+    std::list<Node>& target = priority_map_[it->priority];
+    target.splice(target.begin(), bucket->second, it);
+    if (bucket->second.empty())
+    {
+        priority_map_.erase(bucket);
+    }
+}
+
+template<typename K, typename V, typename KeyPolicy>
+V& lfu::GDSFCache<K, V, KeyPolicy>::get(const K& key)
+{
+    auto it = key_map_.find(key);
+    if (it == key_map_.end())
+    {
+        throw std::out_of_range("Key not found");
+    }
+
+    it->second->frequency++;
+    reposition(it->second);
+    return it->second->value;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+V& lfu::GDSFCache<K, V, KeyPolicy>::put(const K& key)
+{
+    KeyPolicy::validate(key);
+
+    uint64_t cost = 0;
+    V value = load(key, cost);
+
+    auto it = key_map_.find(key);
+    if (it != key_map_.end())
+    {
+        it->second->value = std::move(value);
+        it->second->cost = cost;
+        it->second->frequency++;
+        reposition(it->second);
+        return it->second->value;
+    }
+
+    if (key_map_.size() >= capacity_)
+    {
+        evict();
+    }
+
+    uint64_t priority = inflation_ + cost;
+    std::list<Node>& bucket = priority_map_[priority];
+    bucket.emplace_front(key, std::move(value), 1, cost, priority);
+    key_map_[key] = bucket.begin();
+    return bucket.front().value;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+std::pair<K, V> lfu::GDSFCache<K, V, KeyPolicy>::evict()
+{
+    if (empty())
+    {
+        throw CacheOperationException("Cannot evict from empty cache");
+    }
+
+    auto bucket = priority_map_.begin();
+    Node& node = bucket->second.back();
+    inflation_ = node.priority;
+
+    std::pair<K, V> victim(std::move(node.key), std::move(node.value));
+    bucket->second.pop_back();
+    key_map_.erase(victim.first);
+
+    if (bucket->second.empty())
+    {
+        priority_map_.erase(bucket);
+    }
+
+    return victim;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+uint64_t lfu::GDSFCache<K, V, KeyPolicy>::costOf(const K& key) const
+{
+    auto it = key_map_.find(key);
+    if (it == key_map_.end())
+    {
+        throw std::out_of_range("Key not found");
+    }
+    return it->second->cost;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lfu::GDSFCache<K, V, KeyPolicy>::clear()
+{
+    priority_map_.clear();
+    key_map_.clear();
+    inflation_ = 0;
+    miss_cost_ = 0;
+    load_count_ = 0;
+}
+
+#endif // GDSFCACHE_TPP
@@ -0,0 +1,58 @@
+/**
+ * @file InternedCache.tpp
+ * @brief Реализация LFU кэша с ключами в арене
+ */
+
+#ifndef INTERNEDCACHE_TPP
+#define INTERNEDCACHE_TPP
+
+#include "InternedCache.h"
+
+template<typename V>
+lfu::InternedLFUCache<V>::InternedLFUCache(size_t capacity, SlowGetFunc slow_get_func)
+    : release_(&arena_), cache_(capacity, std::move(slow_get_func))
+{
+    cache_.setEvictionListener(&release_);
+}
+
+template<typename V>
+V& lfu::InternedLFUCache<V>::put(std::string_view key)
+{
+    if (cache_.contains(key))
+    {
+        return cache_.put(key);
+    }
+
+    std::string_view interned = arena_.intern(key);
+    try
+    {
+        return cache_.put(interned);
+    }
+    catch (...)
+    {
+        if (!cache_.contains(interned))
+        {
+            arena_.release(interned);
+        }
+        throw;
+    }
+}
+
+template<typename V>
+std::pair<std::string, V> lfu::InternedLFUCache<V>::evict()
+{
+    // участок ключа уже в списке свободных, но до следующего intern() его содержимое не меняется
+    auto victim = cache_.evict();
+    return {std::string(victim.first), std::move(victim.second)};
+}
+
+template<typename V>
+void lfu::InternedLFUCache<V>::clear()
+{
+    cache_.setEvictionListener(nullptr);
+    cache_.clear();
+    cache_.setEvictionListener(&release_);
+    arena_.clear();
+}
+
+#endif // INTERNEDCACHE_TPP
@@ -0,0 +1,134 @@
+/**
+ * @file KeyPolicy.tpp
+ * @brief Реализация контейнеров для плотных целых ключей
+ */
+
+#ifndef KEYPOLICY_TPP
+#define KEYPOLICY_TPP
+
+#include "KeyPolicy.h"
+#include <algorithm>
+
+template<typename K, typename T>
+size_t keys::DenseKeyMap<K, T>::slotOf(const K& key) const
+{
+    if constexpr (std::is_signed_v<K>)
+    {
+        if (key < 0)
+        {
+            return slots_.size();
+        }
+    }
+    return static_cast<size_t>(key);
+}
+
+template<typename K, typename T>
+typename keys::DenseKeyMap<K, T>::iterator keys::DenseKeyMap<K, T>::find(const K& key)
+{
+    size_t slot = slotOf(key);
+    if (slot >= slots_.size() || !present_[slot])
+    {
+        return end();
+    }
+    return iterator(this, slot);
+}
+
+template<typename K, typename T>
+typename keys::DenseKeyMap<K, T>::const_iterator keys::DenseKeyMap<K, T>::find(const K& key) const
+{
+    size_t slot = slotOf(key);
+    if (slot >= slots_.size() || !present_[slot])
+    {
+        return end();
+    }
+    return const_iterator(this, slot);
+}
+
+template<typename K, typename T>
+size_t keys::DenseKeyMap<K, T>::count(const K& key) const
+{
+    size_t slot = slotOf(key);
+    return slot < slots_.size() && present_[slot];
+}
+
+template<typename K, typename T>
+T& keys::DenseKeyMap<K, T>::operator[](const K& key)
+{
+    return emplace(key, T()).first->second;
+}
+
+template<typename K, typename T>
+std::pair<typename keys::DenseKeyMap<K, T>::iterator, bool> keys::DenseKeyMap<K, T>::emplace(const K& key, T value)
+{
+    DenseKeys::validate(key);
+
+    size_t slot = static_cast<size_t>(key);
+    if (slot >= slots_.size())
+    {
+        size_t new_size = std::max(slot + 1, slots_.size() + slots_.size() / 2);
+        slots_.resize(new_size);
+        present_.resize(new_size, 0);
+    }
+
+    if (present_[slot])
+    {
+        return {iterator(this, slot), false};
+    }
+
+    slots_[slot].first = key;
+    slots_[slot].second = std::move(value);
+    present_[slot] = 1;
+    size_++;
+
+    return {iterator(this, slot), true};
+}
+
+template<typename K, typename T>
+size_t keys::DenseKeyMap<K, T>::erase(const K& key)
+{
+    size_t slot = slotOf(key);
+    if (slot >= slots_.size() || !present_[slot])
+    {
+        return 0;
+    }
+
+    slots_[slot].second = T();
+    present_[slot] = 0;
+    size_--;
+    return 1;
+}
+
+template<typename K, typename T>
+void keys::DenseKeyMap<K, T>::erase(iterator it)
+{
+    erase(it->first);
+}
+
+template<typename K, typename T>
+void keys::DenseKeyMap<K, T>::reserve(size_t n)
+{
+    slots_.reserve(n);
+    present_.reserve(n);
+}
+
+template<typename K, typename T>
+void keys::DenseKeyMap<K, T>::clear()
+{
+    slots_.clear();
+    present_.clear();
+    size_ = 0;
+}
+
+template<typename K>
+void keys::DenseKeys::validate(const K& key)
+{
+    if constexpr (std::is_signed_v<K>)
+    {
+        if (key < 0)
+        {
+            throw std::out_of_range("Dense key map requires non-negative keys");
+        }
+    }
+}
+
+#endif // KEYPOLICY_TPP
@@ -7,18 +7,24 @@
 #define LFUCACHE_TPP
 
 #include "LFUCache.h"
+#include "MappedFile.h"
 #include <stdexcept>
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <optional>
+#include <algorithm>
 
-template <typename K, typename V>
-void lfu::LFUCache<K, V>::increase_frequency(NodeIterator it)
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::increase_frequency(NodeIterator it)
 {
     if (it == NodeIterator())
     {
         throw CacheOperationException("Invalid iterator in increase_frequency");
     }
     
-    Node& node_ref = *it;
-    int old_freq = node_ref.frequency;
+    int old_freq = it->frequency;
+    std::list<Node>& target = frequency_map_[old_freq + 1];
     
     auto freq_it = frequency_map_.find(old_freq);
     if (freq_it == frequency_map_.end() || freq_it->second.empty())
@@ -26,8 +32,9 @@ void lfu::LFUCache<K, V>::increase_frequency(NodeIterator it)
         throw CacheOperationException("Problems with freq map");
     }
     
-    auto node = *it;
-    freq_it->second.erase(it);
+    // узел переносится без копирования, итератор в key_map_ остается валидным
+    target.splice(target.begin(), freq_it->second, it);
+    it->frequency++;
     
     if (freq_it->second.empty())
     {
@@ -37,15 +44,16 @@ void lfu::LFUCache<K, V>::increase_frequency(NodeIterator it)
             min_frequency_++;
         }
     }
-    
-    node.frequency++;
-    frequency_map_[node.frequency].push_front(std::move(node));
-    key_map_[node.key] = frequency_map_[node.frequency].begin();
 }
 
-template<typename K, typename V>
-lfu::LFUCache<K, V>::LFUCache(size_t capacity, SlowGetFunc slow_get_func) 
-    : capacity_(capacity), min_frequency_(0), slow_get_func_(std::move(slow_get_func))
+template<typename K, typename V, typename KeyPolicy>
+lfu::LFUCache<K, V, KeyPolicy>::LFUCache(size_t capacity, SlowGetFunc slow_get_func) 
+    : capacity_(capacity), nominal_capacity_(capacity), resize_chunk_(kDefaultResizeChunk), min_frequency_(0), slow_get_func_(std::move(slow_get_func)), listener_(nullptr),
+      clock_([]() {
+          return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now().time_since_epoch()).count());
+      }),
+      expired_count_(0)
 {
     if (capacity_ <= 0)
     {
@@ -53,54 +61,314 @@ lfu::LFUCache<K, V>::LFUCache(size_t capacity, SlowGetFunc slow_get_func)
     }
 }
 
-template<typename K, typename V>
-V& lfu::LFUCache<K, V>::get(const K& key)
+template<typename K, typename V, typename KeyPolicy>
+typename lfu::LFUCache<K, V, KeyPolicy>::NodeIterator lfu::LFUCache<K, V, KeyPolicy>::find_node(const K& key)
 {
     auto it = key_map_.find(key);
     if (it == key_map_.end())
     {
         throw std::out_of_range("Key not found");
     }
+    return it->second;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+V& lfu::LFUCache<K, V, KeyPolicy>::insert_node(const K& key, V value, bool dirty)
+{
+    if (key_map_.size() >= capacity_)
+    {
+        evict();
+    }
     
-    increase_frequency(it->second);
-    return it->second->value;
+    min_frequency_ = 1;
+    frequency_map_[1].push_front(Node(key, std::move(value), 1, dirty));
+    key_map_[key] = frequency_map_[1].begin();
+    return frequency_map_[1].front().value;
 }
 
-template<typename K, typename V>
-void lfu::LFUCache<K, V>::put(const K& key)
+template<typename K, typename V, typename KeyPolicy>
+V lfu::LFUCache<K, V, KeyPolicy>::load(const K& key)
 {
-    if (capacity_ == 0)
+    if (listener_ != nullptr)
     {
-        return;
+        if (std::optional<V> unwritten = listener_->lookup(key))
+        {
+            return std::move(*unwritten);
+        }
+    }
+    return slow_get_func_(key);
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::remove_node(NodeIterator it)
+{
+    if (it->has_ttl)
+    {
+        wheel_.cancel(it->timer);
+    }
+
+    int freq = it->frequency;
+    auto freq_it = frequency_map_.find(freq);
+    key_map_.erase(it->key);
+    freq_it->second.erase(it);
+
+    // min_frequency_ может остаться меньше настоящего минимума, evict() это учитывает
+    if (freq_it->second.empty())
+    {
+        frequency_map_.erase(freq);
+    }
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::expire_node(NodeIterator it)
+{
+    if (listener_ != nullptr)
+    {
+        listener_->onEvict(it->key, it->value, it->dirty);
+    }
+    expired_count_++;
+    remove_node(it);
+}
+
+template<typename K, typename V, typename KeyPolicy>
+bool lfu::LFUCache<K, V, KeyPolicy>::is_expired(const Node& node, uint64_t now) const
+{
+    return node.has_ttl && node.timer->expire <= now;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+template<typename Q>
+typename lfu::LFUCache<K, V, KeyPolicy>::NodeIterator lfu::LFUCache<K, V, KeyPolicy>::find_live(const Q& key)
+{
+    auto it = key_map_.find(key);
+    if (it == key_map_.end())
+    {
+        return NodeIterator();
+    }
+
+    NodeIterator node = it->second;
+    if (node->has_ttl && is_expired(*node, clock_()))
+    {
+        expire_node(node);
+        return NodeIterator();
+    }
+    return node;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::set_ttl(NodeIterator it, std::chrono::milliseconds ttl, uint64_t now)
+{
+    if (it->has_ttl)
+    {
+        wheel_.cancel(it->timer);
+        it->has_ttl = false;
+    }
+
+    if (ttl.count() > 0)
+    {
+        it->timer = wheel_.schedule(it->key, now + static_cast<uint64_t>(ttl.count()));
+        it->has_ttl = true;
+    }
+}
+
+template<typename K, typename V, typename KeyPolicy>
+size_t lfu::LFUCache<K, V, KeyPolicy>::reclaim_expired(uint64_t now, std::optional<std::pair<K, V>>* first)
+{
+    return wheel_.advance(now, [&](const K& key) {
+        NodeIterator it = key_map_.find(key)->second;
+        it->has_ttl = false;    // таймер уже снят колесом
+
+        if (first != nullptr && !first->has_value())
+        {
+            if (listener_ != nullptr)
+            {
+                listener_->onEvict(it->key, it->value, it->dirty);
+            }
+            first->emplace(it->key, std::move(it->value));
+            expired_count_++;
+            remove_node(it);
+            return;
+        }
+        expire_node(it);
+    });
+}
+
+template<typename K, typename V, typename KeyPolicy>
+size_t lfu::LFUCache<K, V, KeyPolicy>::reclaimExpired()
+{
+    return reclaim_expired(clock_());
+}
+
+template<typename K, typename V, typename KeyPolicy>
+V& lfu::LFUCache<K, V, KeyPolicy>::get(const K& key)
+{
+    NodeIterator it = find_live(key);
+    if (it == NodeIterator())
+    {
+        throw std::out_of_range("Key not found");
     }
     
+    increase_frequency(it);
+    return it->value;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+template<typename Q> requires keys::TransparentLookup<KeyPolicy, K, Q>
+V& lfu::LFUCache<K, V, KeyPolicy>::get(const Q& key)
+{
+    NodeIterator it = find_live(key);
+    if (it == NodeIterator())
+    {
+        throw std::out_of_range("Key not found");
+    }
+    
+    increase_frequency(it);
+    return it->value;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+V& lfu::LFUCache<K, V, KeyPolicy>::getMutable(const K& key)
+{
+    NodeIterator it = find_live(key);
+    if (it == NodeIterator())
+    {
+        throw std::out_of_range("Key not found");
+    }
+    
+    it->dirty = true;
+    increase_frequency(it);
+    return it->value;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::update(const K& key, V value)
+{
+    // до вытеснения: ключ, который политика не примет, не должен стоить кэшу элемента
+    KeyPolicy::validate(key);
+
+    if (key_map_.size() > capacity_)
+    {
+        resizeStep();
+    }
+    if (!wheel_.empty())
+    {
+        reclaim_expired(clock_());
+    }
+
     auto it = key_map_.find(key);
-    if (it != key_map_.end())
+    if (it == key_map_.end())
     {
-        V new_value = slow_get_func_(key);
-        it->second->value = std::move(new_value);
-        increase_frequency(it->second);
+        insert_node(key, std::move(value), true);
         return;
     }
     
-    V value = slow_get_func_(key);
-    if (key_map_.size() >= capacity_)
+    it->second->value = std::move(value);
+    it->second->dirty = true;
+    increase_frequency(it->second);
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::update(const K& key, V value, std::chrono::milliseconds ttl)
+{
+    uint64_t now = clock_();
+    reclaim_expired(now);
+
+    update(key, std::move(value));
+    set_ttl(key_map_.find(key)->second, ttl, now);
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::setTTL(const K& key, std::chrono::milliseconds ttl)
+{
+    uint64_t now = clock_();
+    reclaim_expired(now);
+
+    set_ttl(find_node(key), ttl, now);
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::markDirty(const K& key)
+{
+    find_node(key)->dirty = true;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+bool lfu::LFUCache<K, V, KeyPolicy>::isDirty(const K& key) const
+{
+    auto it = key_map_.find(key);
+    if (it == key_map_.end())
     {
-        evict();
+        throw std::out_of_range("Key not found");
+    }
+    return it->second->dirty;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+V& lfu::LFUCache<K, V, KeyPolicy>::put(const K& key)
+{
+    KeyPolicy::validate(key);
+
+    if (key_map_.size() > capacity_)
+    {
+        resizeStep();
+    }
+    if (!wheel_.empty())
+    {
+        reclaim_expired(clock_());
+    }
+
+    auto it = key_map_.find(key);
+    if (it != key_map_.end())
+    {
+        if (!it->second->dirty)
+        {
+            V new_value = load(key);
+            it->second->value = std::move(new_value);
+        }
+        increase_frequency(it->second);
+        return it->second->value;
     }
     
-    min_frequency_ = 1;
-    frequency_map_[1].push_front(Node(key, slow_get_func_(key), 1));
-    key_map_[key] = frequency_map_[1].begin();
+    return insert_node(key, load(key), false);
 }
 
-template<typename K, typename V>
-void lfu::LFUCache<K, V>::evict()
+template<typename K, typename V, typename KeyPolicy>
+V& lfu::LFUCache<K, V, KeyPolicy>::put(const K& key, std::chrono::milliseconds ttl)
+{
+    uint64_t now = clock_();
+    reclaim_expired(now);
+
+    put(key);
+    NodeIterator it = key_map_.find(key)->second;
+    set_ttl(it, ttl, now);
+    return it->value;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+std::pair<K, V> lfu::LFUCache<K, V, KeyPolicy>::evict()
+{
+    bool expired = false;
+    return evict(expired);
+}
+
+template<typename K, typename V, typename KeyPolicy>
+std::pair<K, V> lfu::LFUCache<K, V, KeyPolicy>::evict(bool& expired, uint64_t* expire)
 {
     if (empty())
     {
         throw CacheOperationException("Cannot evict from empty cache");
     }
+
+    expired = false;
+    if (!wheel_.empty())
+    {
+        std::optional<std::pair<K, V>> first_expired;
+        if (reclaim_expired(clock_(), &first_expired) > 0)
+        {
+            expired = true;
+            return std::move(*first_expired);
+        }
+    }
     
     auto it = frequency_map_.find(min_frequency_);
     
@@ -110,41 +378,359 @@ void lfu::LFUCache<K, V>::evict()
         it = frequency_map_.find(min_frequency_);
     }
     
-    K key_to_remove = it->second.back().key;
+    Node& node = it->second.back();
+    if (listener_ != nullptr)
+    {
+        listener_->onEvict(node.key, node.value, node.dirty);
+    }
+    
+    if (expire != nullptr)
+    {
+        *expire = node.has_ttl ? node.timer->expire : 0;
+    }
+    if (node.has_ttl)
+    {
+        wheel_.cancel(node.timer);
+    }
+    
+    std::pair<K, V> victim(std::move(node.key), std::move(node.value));
     it->second.pop_back();
     
-    key_map_.erase(key_to_remove);
+    key_map_.erase(victim.first);
     
     if (it->second.empty())
     {
         frequency_map_.erase(min_frequency_);
     }
+    
+    return victim;
 }
 
-template<typename K, typename V>
-size_t lfu::LFUCache<K, V>::size() const
+template<typename K, typename V, typename KeyPolicy>
+size_t lfu::LFUCache<K, V, KeyPolicy>::size() const
 {
     return key_map_.size();
 }
 
-template<typename K, typename V>
-bool lfu::LFUCache<K, V>::empty() const
+template<typename K, typename V, typename KeyPolicy>
+bool lfu::LFUCache<K, V, KeyPolicy>::empty() const
 {
     return key_map_.empty();
 }
 
-template<typename K, typename V>
-size_t lfu::LFUCache<K, V>::capacity() const
+template<typename K, typename V, typename KeyPolicy>
+size_t lfu::LFUCache<K, V, KeyPolicy>::capacity() const
 {
     return capacity_;
 }
 
-template<typename K, typename V>
-void lfu::LFUCache<K, V>::clear()
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::resize(size_t new_capacity)
+{
+    if (new_capacity == 0)
+    {
+        throw std::invalid_argument("Cache capacity must be greater than 0");
+    }
+    
+    nominal_capacity_ = new_capacity;
+    capacity_ = new_capacity;
+    resizeStep();
+}
+
+template<typename K, typename V, typename KeyPolicy>
+size_t lfu::LFUCache<K, V, KeyPolicy>::resizeStep()
+{
+    for (size_t evicted = 0; evicted < resize_chunk_ && key_map_.size() > capacity_; evicted++)
+    {
+        evict();
+    }
+    return shrinkPending();
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::setResizeChunk(size_t chunk)
+{
+    if (chunk == 0)
+    {
+        throw std::invalid_argument("Resize chunk must be greater than 0");
+    }
+    resize_chunk_ = chunk;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::onMemoryPressure(double level)
+{
+    if (!(level >= 0.0 && level <= 1.0))
+    {
+        throw std::invalid_argument("Memory pressure level must be in [0, 1]");
+    }
+    
+    size_t target = static_cast<size_t>(static_cast<double>(nominal_capacity_) * (1.0 - level));
+    capacity_ = std::max<size_t>(1, target);
+    resizeStep();
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::clear()
 {
+    if (listener_ != nullptr)
+    {
+        for (const auto& bucket : frequency_map_)
+        {
+            for (const Node& node : bucket.second)
+            {
+                if (node.dirty)
+                {
+                    listener_->onEvict(node.key, node.value, true);
+                }
+            }
+        }
+    }
+    
     frequency_map_.clear();
     key_map_.clear();
+    wheel_.clear();
     min_frequency_ = 0;
 }
 
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::saveSnapshot(const std::string& path) const
+{
+    static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                  "Snapshots require trivially copyable key and value types");
+    static_assert(sizeof(SnapshotHeader) % alignof(SnapshotRecord) == 0,
+                  "Snapshot records must stay aligned after the header");
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        throw StorageException("Cannot open snapshot file " + path);
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+    header.version = kSnapshotVersion;
+    header.record_size = sizeof(SnapshotRecord);
+    header.count = key_map_.size();
+    header.capacity = capacity_;
+    header.min_frequency = min_frequency_;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const uint64_t now = wheel_.empty() ? 0 : clock_();
+    const size_t chunk_size = 1 << 16;
+    std::vector<SnapshotRecord> chunk;
+    chunk.reserve(chunk_size);
+
+    for (const auto& bucket : frequency_map_)
+    {
+        for (const Node& node : bucket.second)
+        {
+            SnapshotRecord record;
+            std::memset(&record, 0, sizeof(record));
+            record.key = node.key;
+            record.value = node.value;
+            record.frequency = node.frequency;
+            record.dirty = node.dirty ? 1 : 0;
+            record.ttl_left = -1;
+            if (node.has_ttl)
+            {
+                record.ttl_left = node.timer->expire > now ? static_cast<int64_t>(node.timer->expire - now) : 0;
+            }
+            chunk.push_back(record);
+
+            if (chunk.size() == chunk_size)
+            {
+                out.write(reinterpret_cast<const char*>(chunk.data()), chunk.size() * sizeof(SnapshotRecord));
+                chunk.clear();
+            }
+        }
+    }
+
+    out.write(reinterpret_cast<const char*>(chunk.data()), chunk.size() * sizeof(SnapshotRecord));
+
+    if (!out.flush())
+    {
+        throw StorageException("Failed to write snapshot " + path);
+    }
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lfu::LFUCache<K, V, KeyPolicy>::loadSnapshot(const std::string& path)
+{
+    static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                  "Snapshots require trivially copyable key and value types");
+
+    storage::MappedFile file(path);
+
+    if (file.size() < sizeof(SnapshotHeader))
+    {
+        throw StorageException("Snapshot is truncated: " + path);
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0 ||
+        header.version != kSnapshotVersion)
+    {
+        throw StorageException("Unknown snapshot format: " + path);
+    }
+    if (header.record_size != sizeof(SnapshotRecord))
+    {
+        throw StorageException("Snapshot was written for different key/value types: " + path);
+    }
+    // деление вместо умножения: count из файла может переполнить произведение
+    const size_t body_size = file.size() - sizeof(SnapshotHeader);
+    if (body_size % sizeof(SnapshotRecord) != 0 || body_size / sizeof(SnapshotRecord) != header.count)
+    {
+        throw StorageException("Snapshot size does not match record count: " + path);
+    }
+    if (header.count > capacity_)
+    {
+        throw StorageException("Snapshot holds " + std::to_string(header.count) +
+                               " entries, cache capacity is " + std::to_string(capacity_));
+    }
+
+    const SnapshotRecord* records = reinterpret_cast<const SnapshotRecord*>(file.data() + sizeof(SnapshotHeader));
+
+    // min_frequency из заголовка не используется: при значении выше всех частот evict() не нашел бы список
+    int min_frequency = 0;
+    for (uint64_t i = 0; i < header.count; i++)
+    {
+        if (records[i].frequency <= 0)
+        {
+            throw StorageException("Snapshot record has non-positive frequency: " + path);
+        }
+        try
+        {
+            KeyPolicy::validate(records[i].key);
+        }
+        catch (const std::out_of_range&)
+        {
+            throw StorageException("Snapshot key is not supported by the key policy: " + path);
+        }
+        if (min_frequency == 0 || records[i].frequency < min_frequency)
+        {
+            min_frequency = records[i].frequency;
+        }
+    }
+
+    clear();
+    key_map_.reserve(header.count);
+    const uint64_t now = clock_();
+    wheel_.advance(now, [](const K&) {});
+
+    // записи одной частоты идут подряд, поэтому список ищется только при смене частоты
+    std::list<Node>* bucket = nullptr;
+    int bucket_frequency = 0;
+
+    for (uint64_t i = 0; i < header.count; i++)
+    {
+        const SnapshotRecord& record = records[i];
+
+        if (bucket == nullptr || record.frequency != bucket_frequency)
+        {
+            bucket_frequency = record.frequency;
+            bucket = &frequency_map_[bucket_frequency];
+        }
+
+        bucket->emplace_back(record.key, record.value, record.frequency, record.dirty != 0);
+        if (!key_map_.emplace(record.key, std::prev(bucket->end())).second)
+        {
+            clear();
+            throw StorageException("Duplicate key in snapshot: " + path);
+        }
+        if (record.ttl_left >= 0)
+        {
+            Node& node = bucket->back();
+            node.timer = wheel_.schedule(record.key, now + static_cast<uint64_t>(record.ttl_left));
+            node.has_ttl = true;
+        }
+    }
+
+    min_frequency_ = min_frequency;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+size_t lfu::LFUCache<K, V, KeyPolicy>::evictionRank(const K& key, size_t limit) const
+{
+    auto it = key_map_.find(key);
+    if (it == key_map_.end())
+    {
+        throw std::out_of_range("Key not found");
+    }
+    return eviction_rank(*it->second, limit);
+}
+
+template<typename K, typename V, typename KeyPolicy>
+bool lfu::LFUCache<K, V, KeyPolicy>::evictionRank(const K& key, size_t limit, size_t& rank) const
+{
+    auto it = key_map_.find(key);
+    if (it == key_map_.end())
+    {
+        return false;
+    }
+    rank = eviction_rank(*it->second, limit);
+    return true;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+size_t lfu::LFUCache<K, V, KeyPolicy>::eviction_rank(const Node& node, size_t limit) const
+{
+    size_t rank = 0;
+    auto count = [&](const std::list<Node>& nodes)
+    {
+        rank += nodes.size();
+        return rank >= limit;
+    };
+
+    // min_frequency_ не больше минимальной частоты, поэтому перебор от нее по возрастанию
+    // останавливается на первых limit жертвах. Если частоты разрежены, дешевле пройти карту целиком
+    if (static_cast<size_t>(node.frequency - std::min(min_frequency_, node.frequency)) <= frequency_map_.size())
+    {
+        for (int frequency = min_frequency_; frequency < node.frequency; frequency++)
+        {
+            auto nodes = frequency_map_.find(frequency);
+            if (nodes != frequency_map_.end() && count(nodes->second))
+            {
+                return limit;
+            }
+        }
+    }
+    else
+    {
+        for (const auto& [frequency, nodes] : frequency_map_)
+        {
+            if (frequency < node.frequency && count(nodes))
+            {
+                return limit;
+            }
+        }
+    }
+
+    // внутри списка частоты жертва берется с хвоста
+    const std::list<Node>& same = frequency_map_.find(node.frequency)->second;
+    for (auto r = same.rbegin(); r != same.rend() && rank < limit; ++r, ++rank)
+    {
+        if (&*r == &node)
+        {
+            return rank;
+        }
+    }
+    return std::min(rank, limit);
+}
+
+template<typename K, typename V, typename KeyPolicy>
+template<typename Func>
+void lfu::LFUCache<K, V, KeyPolicy>::forEachFrequency(Func&& func) const
+{
+    for (const auto& [frequency, nodes] : frequency_map_)
+    {
+        if (!nodes.empty())
+        {
+            func(frequency, nodes.size());
+        }
+    }
+}
+
 #endif // LFUCACHE_TPP
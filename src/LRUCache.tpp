@@ -0,0 +1,76 @@
+/**
+ * @file LRUCache.tpp
+ * @brief Реализация шаблонных методов LRU кэша
+ */
+
+#ifndef LRUCACHE_TPP
+#define LRUCACHE_TPP
+
+#include "LRUCache.h"
+
+template<typename K, typename V, typename KeyPolicy>
+lru::LRUCache<K, V, KeyPolicy>::LRUCache(size_t capacity, SlowGetFunc slow_get_func)
+    : capacity_(capacity), slow_get_func_(std::move(slow_get_func))
+{
+    if (capacity_ == 0)
+    {
+        throw std::invalid_argument("Cache capacity must be greater than 0");
+    }
+}
+
+template<typename K, typename V, typename KeyPolicy>
+V& lru::LRUCache<K, V, KeyPolicy>::get(const K& key)
+{
+    auto it = key_map_.find(key);
+    if (it == key_map_.end())
+    {
+        throw std::out_of_range("Key not found");
+    }
+
+    recency_list_.splice(recency_list_.begin(), recency_list_, it->second);
+    return it->second->value;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lru::LRUCache<K, V, KeyPolicy>::put(const K& key)
+{
+    KeyPolicy::validate(key);
+
+    auto it = key_map_.find(key);
+    if (it != key_map_.end())
+    {
+        it->second->value = slow_get_func_(key);
+        recency_list_.splice(recency_list_.begin(), recency_list_, it->second);
+        return;
+    }
+
+    V value = slow_get_func_(key);
+    if (key_map_.size() >= capacity_)
+    {
+        evict();
+    }
+
+    recency_list_.emplace_front(key, std::move(value));
+    key_map_[key] = recency_list_.begin();
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lru::LRUCache<K, V, KeyPolicy>::evict()
+{
+    if (recency_list_.empty())
+    {
+        throw CacheOperationException("Cannot evict from empty cache");
+    }
+
+    key_map_.erase(recency_list_.back().key);
+    recency_list_.pop_back();
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void lru::LRUCache<K, V, KeyPolicy>::clear()
+{
+    recency_list_.clear();
+    key_map_.clear();
+}
+
+#endif // LRUCACHE_TPP
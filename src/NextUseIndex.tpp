@@ -0,0 +1,208 @@
+/**
+ * @file NextUseIndex.tpp
+ * @brief Реализация индекса следующего обращения
+ */
+
+#ifndef NEXTUSEINDEX_TPP
+#define NEXTUSEINDEX_TPP
+
+#include "NextUseIndex.h"
+#include <thread>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <type_traits>
+
+inline uint64_t opt::NextUseIndex::checksum(const uint64_t* values, size_t count)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < count; i++)
+    {
+        h = (h ^ values[i]) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+template<typename K>
+uint64_t opt::NextUseIndex::traceHash(const std::vector<K>& requests)
+{
+    uint64_t h = 0xcbf29ce484222325ULL ^ requests.size();
+    for (const K& key : requests)
+    {
+        uint64_t value;
+        if constexpr (std::is_integral_v<K>)
+        {
+            value = static_cast<uint64_t>(key);
+        }
+        else
+        {
+            value = static_cast<uint64_t>(std::hash<K>{}(key));
+        }
+        h = (h ^ value) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+template<typename K, typename KeyPolicy>
+std::shared_ptr<const opt::NextUseIndex> opt::NextUseIndex::build(const std::vector<K>& requests, size_t threads)
+{
+    // на меньших отрезках запуск потока дороже самого прохода
+    constexpr size_t kMinSegment = 1 << 16;
+
+    if (threads == 0)
+    {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        threads = std::min(threads, std::max<size_t>(1, requests.size() / kMinSegment));
+    }
+    threads = std::max<size_t>(1, std::min(threads, requests.size()));
+
+    std::shared_ptr<NextUseIndex> index(new NextUseIndex());
+    index->owned_.resize(requests.size());
+    index->trace_hash_ = traceHash(requests);
+    uint64_t* next = index->owned_.data();
+
+    // каждый отрезок проходится с конца: карта хранит ближайшее уже встреченное обращение ключа.
+    // После прохода в ней остаются первые обращения ключей в отрезке, а в tails - последние,
+    // чьи ссылки ведут за пределы отрезка и заполняются при сшивании
+    struct Segment
+    {
+        typename KeyPolicy::template Map<K, uint64_t> first;
+        std::vector<size_t> tails;
+    };
+
+    std::vector<Segment> segments(threads);
+    std::vector<std::exception_ptr> errors(threads);
+    const size_t segment_size = (requests.size() + threads - 1) / threads;
+
+    auto scan = [&](size_t s)
+    {
+        try
+        {
+            size_t begin = std::min(requests.size(), s * segment_size);
+            size_t end = std::min(requests.size(), begin + segment_size);
+            Segment& segment = segments[s];
+            for (size_t i = end; i-- > begin;)
+            {
+                auto [it, inserted] = segment.first.emplace(requests[i], i);
+                if (inserted)
+                {
+                    segment.tails.push_back(i);
+                }
+                else
+                {
+                    next[i] = it->second;
+                    it->second = i;
+                }
+            }
+        }
+        catch (...)
+        {
+            errors[s] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t s = 1; s < threads; s++)
+    {
+        workers.emplace_back(scan, s);
+    }
+    scan(0);
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    typename KeyPolicy::template Map<K, uint64_t> following;
+    for (size_t s = threads; s-- > 0;)
+    {
+        for (size_t tail : segments[s].tails)
+        {
+            auto it = following.find(requests[tail]);
+            next[tail] = it == following.end() ? kNever : it->second;
+        }
+        for (const auto& [key, position] : segments[s].first)
+        {
+            following[key] = position;
+        }
+    }
+
+    index->next_ = next;
+    index->size_ = requests.size();
+    return index;
+}
+
+inline std::shared_ptr<const opt::NextUseIndex> opt::NextUseIndex::load(const std::string& path, uint64_t trace_hash)
+{
+    auto file = std::make_unique<storage::MappedFile>(path);
+
+    NextUseHeader header;
+    if (file->size() < sizeof(header))
+    {
+        throw StorageException("Next-use index is truncated: " + path);
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+
+    if (std::memcmp(header.magic, kNextUseMagic, sizeof(header.magic)) != 0 || header.version != kNextUseVersion)
+    {
+        throw StorageException("Unknown next-use index format: " + path);
+    }
+    if ((file->size() - sizeof(header)) / sizeof(uint64_t) != header.count ||
+        (file->size() - sizeof(header)) % sizeof(uint64_t) != 0)
+    {
+        throw StorageException("Next-use index size does not match its header: " + path);
+    }
+    if (header.trace_hash != trace_hash)
+    {
+        throw StorageException("Next-use index was built for another trace: " + path);
+    }
+
+    // заголовок кратен 8 байтам, а отображение выровнено по странице
+    const uint64_t* values = reinterpret_cast<const uint64_t*>(file->data() + sizeof(header));
+    if (checksum(values, header.count) != header.checksum)
+    {
+        throw StorageException("Next-use index is corrupted: " + path);
+    }
+
+    std::shared_ptr<NextUseIndex> index(new NextUseIndex());
+    index->file_ = std::move(file);
+    index->next_ = values;
+    index->size_ = header.count;
+    index->trace_hash_ = header.trace_hash;
+    return index;
+}
+
+inline void opt::NextUseIndex::save(const std::string& path) const
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        throw StorageException("Cannot open next-use index file " + path);
+    }
+
+    NextUseHeader header{};
+    std::memcpy(header.magic, kNextUseMagic, sizeof(header.magic));
+    header.version = kNextUseVersion;
+    header.count = size_;
+    header.trace_hash = trace_hash_;
+    header.checksum = checksum(next_, size_);
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(next_), size_ * sizeof(uint64_t));
+
+    if (!out.flush())
+    {
+        throw StorageException("Failed to write next-use index " + path);
+    }
+}
+
+#endif // NEXTUSEINDEX_TPP
@@ -9,14 +9,22 @@
 #include "OptimalCache.h"
 #include <iostream>
 #include <stdexcept>
+#include <algorithm>
 
-template<typename K, typename V>
-opt::OptimalCache<K, V>::OptimalCache(size_t capacity, std::function<V(K)> slow_get_func) 
+template<typename K, typename V, typename KeyPolicy>
+opt::OptimalCache<K, V, KeyPolicy>::OptimalCache(size_t capacity, std::function<V(const K&)> slow_get_func) 
     : capacity_(capacity), 
       slow_get_func_(std::move(slow_get_func)),
+      clock_([]() {
+          return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now().time_since_epoch()).count());
+      }),
+      cost_aware_(false),
+      track_cost_(false),
       hit_count_(0),
       miss_count_(0),
-      current_step_(0)
+      current_step_(0),
+      miss_cost_(0)
 {
     if (capacity_ == 0)
     {
@@ -24,162 +32,148 @@ opt::OptimalCache<K, V>::OptimalCache(size_t capacity, std::function<V(K)> slow_
     }
 }
 
-template<typename K, typename V>
-void opt::OptimalCache<K, V>::preprocessRequests(const std::vector<K>& requests)
+template<typename K, typename V, typename KeyPolicy>
+void opt::OptimalCache<K, V, KeyPolicy>::preprocessRequests(const std::vector<K>& requests, size_t threads)
 {
-    future_indices_.clear();
+    index_ = NextUseIndex::build<K, KeyPolicy>(requests, threads);
     clear();
+}
 
-
-
-
-    current_step_ = 0;
-    
-    for (size_t i = 0; i < requests.size(); i++)
-    {
-        future_indices_[requests[i]].push(i);
-    }
-    
-    for (auto& pair : future_indices_)
+template<typename K, typename V, typename KeyPolicy>
+void opt::OptimalCache<K, V, KeyPolicy>::setNextUseIndex(std::shared_ptr<const NextUseIndex> index)
+{
+    if (!index)
     {
-        pair.second.push(std::numeric_limits<size_t>::max());
+        throw std::invalid_argument("Next-use index must not be null");
     }
+    index_ = std::move(index);
+    clear();
 }
 
-template<typename K, typename V>
-size_t opt::OptimalCache<K, V>::getNextUse(const K& key) const
+template<typename K, typename V, typename KeyPolicy>
+size_t opt::OptimalCache<K, V, KeyPolicy>::getNextUse(const K& key) const
 {
-    auto it = future_indices_.find(key);
-    if (it == future_indices_.end() || it->second.empty())
+    auto it = slot_of_.find(key);
+    if (it == slot_of_.end())
     {
         return std::numeric_limits<size_t>::max();
     }
-    return it->second.front();
+    return slot_next_use_[it->second];
 }
 
-template<typename K, typename V>
-K opt::OptimalCache<K, V>::findEvictionKey()
+template<typename K, typename V, typename KeyPolicy>
+size_t opt::OptimalCache<K, V, KeyPolicy>::findEvictionSlot() const
 {
-    if (current_cache_.empty())
+    if (slot_next_use_.empty())
     {
-        return K();
+        throw CacheOperationException("Cannot evict from empty cache");
     }
     
-    K key_to_evict = K();
-    size_t farthest_use = 0;
-    
-    for (const K& cached_key : current_cache_)
+    return simd::argmax(slot_next_use_.data(), slot_next_use_.size());
+}
+
+template<typename K, typename V, typename KeyPolicy>
+size_t opt::OptimalCache<K, V, KeyPolicy>::findCostAwareSlot() const
+{
+    if (slot_next_use_.empty())
     {
-        auto it = future_indices_.find(cached_key);
-        if (it == future_indices_.end())
-        {
-            return cached_key;
-        }
-        
-        while (!it->second.empty() && it->second.front() < current_step_)
-        {
-            it->second.pop();
-        }
-        
-        if (it->second.empty() || it->second.front() == std::numeric_limits<size_t>::max())
+        throw CacheOperationException("Cannot evict from empty cache");
+    }
+
+    size_t best = 0;
+    double best_score = -1.0;
+    for (size_t slot = 0; slot < slot_next_use_.size(); slot++)
+    {
+        if (slot_next_use_[slot] == std::numeric_limits<size_t>::max())
         {
-            return cached_key;
+            return slot;
         }
-        
-        if (it->second.front() > farthest_use)
+
+        double distance = static_cast<double>(slot_next_use_[slot] - current_step_ + 1);
+        double score = distance / static_cast<double>(slot_cost_[slot]);
+        if (score > best_score)
         {
-            farthest_use = it->second.front();
-            key_to_evict = cached_key;
+            best = slot;
+            best_score = score;
         }
     }
-    
-    return key_to_evict;
+    return best;
 }
 
-template<typename K, typename V>
-bool opt::OptimalCache<K, V>::step(const K& key)
+template<typename K, typename V, typename KeyPolicy>
+bool opt::OptimalCache<K, V, KeyPolicy>::step(const K& key)
 {
-    if (future_indices_.empty())
+    KeyPolicy::validate(key);
+
+    if (!index_)
     {
         throw CacheOperationException("preprocessRequests must be called before step");
     }
-    
-    current_step_++;
-    
-    auto it = future_indices_.find(key);
-    if (it != future_indices_.end() && !it->second.empty())
+    if (current_step_ >= index_->size())
     {
-        if (it->second.front() == current_step_ - 1)
-        {
-            it->second.pop();
-        }
+        throw CacheOperationException("All preprocessed requests have already been simulated");
     }
     
-    if (current_cache_.find(key) != current_cache_.end())
+    size_t next_use = static_cast<size_t>(index_->next(current_step_));
+    current_step_++;
+    
+    auto slot_it = slot_of_.find(key);
+    if (slot_it != slot_of_.end())
     {
+        slot_next_use_[slot_it->second] = next_use;
         hit_count_++;
         return true;
     }
     
     miss_count_++;
     
+    // без учета стоимости все загрузки равноценны и часы не нужны
+    const bool measure = cost_aware_ || track_cost_;
+    uint64_t load_start = measure ? clock_() : 0;
     V value = slow_get_func_(key);
+    uint64_t cost = 1;
+    if (measure)
+    {
+        cost = std::max<uint64_t>(1, clock_() - load_start);
+        miss_cost_ += cost;
+    }
 
-    if (current_cache_.size() >= capacity_)
+    if (slot_keys_.size() >= capacity_)
     {
-        K key_to_evict = findEvictionKey();
+        size_t slot = cost_aware_ ? findCostAwareSlot() : findEvictionSlot();
         
-        if (key_to_evict != K() && current_cache_.find(key_to_evict) != current_cache_.end())
-        {
-            current_cache_.erase(key_to_evict);
-            cache_values_.erase(key_to_evict);
-        }
-        else if (!current_cache_.empty())
-        {
-            K first_key = *current_cache_.begin();
-            current_cache_.erase(current_cache_.begin());
-            cache_values_.erase(first_key);
-        }
+        slot_of_.erase(slot_keys_[slot]);
+        slot_keys_[slot] = key;
+        slot_values_[slot] = std::move(value);
+        slot_next_use_[slot] = next_use;
+        slot_cost_[slot] = cost;
+        slot_of_[key] = slot;
+        
+        return false;
     }
     
-    current_cache_.insert(key);
-    cache_values_[key] = std::move(value);
+    slot_of_[key] = slot_keys_.size();
+    slot_keys_.push_back(key);
+    slot_values_.push_back(std::move(value));
+    slot_next_use_.push_back(next_use);
+    slot_cost_.push_back(cost);
     
     return false;
 }
 
-template<typename K, typename V>
-size_t opt::OptimalCache<K, V>::simulate(const std::vector<K>& requests)
+template<typename K, typename V, typename KeyPolicy>
+size_t opt::OptimalCache<K, V, KeyPolicy>::simulate(const std::vector<K>& requests)
 {
-    if (future_indices_.empty())
+    if (!index_)
     {
         throw CacheOperationException("preprocessRequests must be called before simulate");
     }
-    
-    clear();
-    current_step_ = 0;
-    
-
-
-
-
-    std::unordered_map<K, std::queue<size_t>> new_future_indices;
-    for (const auto& pair : future_indices_)
-    {
-        new_future_indices[pair.first] = std::queue<size_t>();
-    }
-    
-    for (size_t i = 0; i < requests.size(); i++)
-    {
-        new_future_indices[requests[i]].push(i);
-    }
-    
-    for (auto& pair : new_future_indices)
+    if (requests.size() != index_->size())
     {
-        pair.second.push(std::numeric_limits<size_t>::max());
+        throw CacheOperationException("Requests differ from the preprocessed trace");
     }
     
-    future_indices_ = std::move(new_future_indices);
+    clear();
     
     for (const K& key : requests)
     {
@@ -189,50 +183,50 @@ size_t opt::OptimalCache<K, V>::simulate(const std::vector<K>& requests)
     return hit_count_;
 }
 
-template<typename K, typename V>
-std::vector<std::pair<K, V>> opt::OptimalCache<K, V>::getCacheContents() const
+template<typename K, typename V, typename KeyPolicy>
+std::vector<std::pair<K, V>> opt::OptimalCache<K, V, KeyPolicy>::getCacheContents() const
 {
     std::vector<std::pair<K, V>> contents;
-    contents.reserve(current_cache_.size());
+    contents.reserve(slot_keys_.size());
     
-    for (const K& key : current_cache_)
+    for (size_t slot = 0; slot < slot_keys_.size(); slot++)
     {
-        auto it = cache_values_.find(key);
-        if (it != cache_values_.end())
-        {
-            contents.emplace_back(key, it->second);
-        }
+        contents.emplace_back(slot_keys_[slot], slot_values_[slot]);
     }
     
     return contents;
 }
 
-template<typename K, typename V>
-V opt::OptimalCache<K, V>::get(const K& key) const
+template<typename K, typename V, typename KeyPolicy>
+V opt::OptimalCache<K, V, KeyPolicy>::get(const K& key) const
 {
-    auto it = cache_values_.find(key);
-    if (it == cache_values_.end())
+    auto it = slot_of_.find(key);
+    if (it == slot_of_.end())
     {
         throw std::out_of_range("Key not found in cache");
     }
-    return it->second;
+    return slot_values_[it->second];
 }
 
-template<typename K, typename V>
-double opt::OptimalCache<K, V>::getHitRate() const
+template<typename K, typename V, typename KeyPolicy>
+double opt::OptimalCache<K, V, KeyPolicy>::getHitRate() const
 {
     size_t total = hit_count_ + miss_count_;
     if (total == 0) return 0.0;
     return static_cast<double>(hit_count_) / total;
 }
 
-template<typename K, typename V> void opt::OptimalCache<K, V>::clear()
+template<typename K, typename V, typename KeyPolicy> void opt::OptimalCache<K, V, KeyPolicy>::clear()
 {
-    current_cache_.clear();
-    cache_values_.clear();
+    slot_keys_.clear();
+    slot_values_.clear();
+    slot_next_use_.clear();
+    slot_cost_.clear();
+    slot_of_.clear();
     hit_count_ = 0;
     miss_count_ = 0;
     current_step_ = 0;
+    miss_cost_ = 0;
 }
 
 #endif // OPTIMALCACHE_TPP
@@ -0,0 +1,202 @@
+/**
+ * @file PartitionedCache.tpp
+ * @brief Реализация кэша с разделяемым бюджетом
+ */
+
+#ifndef PARTITIONEDCACHE_TPP
+#define PARTITIONEDCACHE_TPP
+
+#include "PartitionedCache.h"
+#include <algorithm>
+#include <string>
+
+template<typename K, typename V, typename KeyPolicy>
+part::PartitionedCache<K, V, KeyPolicy>::PartitionedCache(size_t total_capacity, size_t tenant_count,
+                                                          SlowGetFunc slow_get_func, PartitionOptions options)
+    : total_capacity_(total_capacity), options_(options), requests_in_epoch_(0), rebalance_count_(0)
+{
+    if (tenant_count == 0)
+    {
+        throw ConfigurationException("Partitioned cache needs at least one tenant");
+    }
+    if (options_.min_capacity == 0)
+    {
+        options_.min_capacity = 1;
+    }
+    if (total_capacity_ < tenant_count * options_.min_capacity)
+    {
+        throw ConfigurationException("Total capacity " + std::to_string(total_capacity_) +
+                                     " is too small for " + std::to_string(tenant_count) + " tenants");
+    }
+    if (options_.epoch_length == 0)
+    {
+        throw ConfigurationException("Epoch length must be > 0");
+    }
+    if (options_.rebalance_step == 0)
+    {
+        options_.rebalance_step = std::max<size_t>(1, total_capacity_ / tenant_count / 16);
+    }
+
+    tenants_.resize(tenant_count);
+    for (size_t i = 0; i < tenant_count; i++)
+    {
+        size_t capacity = total_capacity_ / tenant_count + (i < total_capacity_ % tenant_count ? 1 : 0);
+
+        tenants_[i].cache = std::make_unique<Cache>(capacity, slow_get_func);
+        tenants_[i].ghost = std::make_unique<GhostList>(options_.rebalance_step);
+        tenants_[i].cache->setEvictionListener(tenants_[i].ghost.get());
+    }
+}
+
+template<typename K, typename V, typename KeyPolicy>
+void part::PartitionedCache<K, V, KeyPolicy>::GhostList::onEvict(const K& key, const V& value, bool dirty)
+{
+    if (next != nullptr)
+    {
+        next->onEvict(key, value, dirty);
+    }
+
+    if (index.find(key) != index.end())
+    {
+        return;
+    }
+
+    keys.push_front(key);
+    index.emplace(key, keys.begin());
+    if (keys.size() > limit)
+    {
+        index.erase(keys.back());
+        keys.pop_back();
+    }
+}
+
+template<typename K, typename V, typename KeyPolicy>
+std::optional<V> part::PartitionedCache<K, V, KeyPolicy>::GhostList::lookup(const K& key)
+{
+    return next != nullptr ? next->lookup(key) : std::nullopt;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+bool part::PartitionedCache<K, V, KeyPolicy>::GhostList::take(const K& key)
+{
+    auto it = index.find(key);
+    if (it == index.end())
+    {
+        return false;
+    }
+
+    keys.erase(it->second);
+    index.erase(it);
+    return true;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+typename part::PartitionedCache<K, V, KeyPolicy>::Tenant& part::PartitionedCache<K, V, KeyPolicy>::tenantAt(size_t tenant)
+{
+    if (tenant >= tenants_.size())
+    {
+        throw std::out_of_range("Unknown tenant " + std::to_string(tenant));
+    }
+    return tenants_[tenant];
+}
+
+template<typename K, typename V, typename KeyPolicy>
+const typename part::PartitionedCache<K, V, KeyPolicy>::Tenant& part::PartitionedCache<K, V, KeyPolicy>::tenantAt(size_t tenant) const
+{
+    if (tenant >= tenants_.size())
+    {
+        throw std::out_of_range("Unknown tenant " + std::to_string(tenant));
+    }
+    return tenants_[tenant];
+}
+
+template<typename K, typename V, typename KeyPolicy>
+bool part::PartitionedCache<K, V, KeyPolicy>::access(size_t tenant_index, const K& key)
+{
+    Tenant& tenant = tenantAt(tenant_index);
+    const size_t step = options_.rebalance_step;
+
+    size_t rank = 0;
+    bool hit = tenant.cache->evictionRank(key, step, rank);
+    if (hit)
+    {
+        // элемент среди step ближайших жертв: кэш на step меньше его бы уже потерял
+        if (rank < step)
+        {
+            tenant.loss += 1.0;
+        }
+        tenant.cache->get(key);
+    }
+    else
+    {
+        // ключ среди step последних вытесненных: кэш на step больше его бы еще держал
+        if (tenant.ghost->take(key))
+        {
+            tenant.gain += 1.0;
+        }
+        tenant.cache->put(key);
+    }
+
+    tenant.requests++;
+    if (hit)
+    {
+        tenant.hits++;
+    }
+
+    if (++requests_in_epoch_ >= options_.epoch_length)
+    {
+        rebalance();
+    }
+
+    return hit;
+}
+
+template<typename K, typename V, typename KeyPolicy>
+bool part::PartitionedCache<K, V, KeyPolicy>::rebalance()
+{
+    requests_in_epoch_ = 0;
+    const size_t step = options_.rebalance_step;
+
+    size_t receiver = 0;
+    for (size_t i = 1; i < tenants_.size(); i++)
+    {
+        if (tenants_[i].gain > tenants_[receiver].gain)
+        {
+            receiver = i;
+        }
+    }
+
+    size_t donor = tenants_.size();
+    for (size_t i = 0; i < tenants_.size(); i++)
+    {
+        if (i == receiver || tenants_[i].cache->capacity() < options_.min_capacity + step)
+        {
+            continue;
+        }
+        if (donor == tenants_.size() || tenants_[i].loss < tenants_[donor].loss)
+        {
+            donor = i;
+        }
+    }
+
+    bool moved = false;
+    if (donor != tenants_.size() && tenants_[receiver].gain > tenants_[donor].loss)
+    {
+        // вытесненные при уменьшении ключи попадают в теневой список донора
+        tenants_[donor].cache->resize(tenants_[donor].cache->capacity() - step);
+        tenants_[receiver].cache->resize(tenants_[receiver].cache->capacity() + step);
+        rebalance_count_++;
+        moved = true;
+    }
+
+    // оценки затухают, чтобы следить за сменой фаз нагрузки
+    for (Tenant& tenant : tenants_)
+    {
+        tenant.gain /= 2.0;
+        tenant.loss /= 2.0;
+    }
+
+    return moved;
+}
+
+#endif // PARTITIONEDCACHE_TPP
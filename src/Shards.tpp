@@ -0,0 +1,86 @@
+/**
+ * @file Shards.tpp
+ * @brief Реализация пространственной выборки
+ */
+
+#ifndef SHARDS_TPP
+#define SHARDS_TPP
+
+#include "Shards.h"
+#include <cmath>
+#include <algorithm>
+
+inline shards::Estimate shards::summarize(const std::vector<double>& values)
+{
+    if (values.empty())
+    {
+        return {0.0, 0.0};
+    }
+
+    double sum = 0.0;
+    for (double value : values)
+    {
+        sum += value;
+    }
+    double mean = sum / values.size();
+
+    if (values.size() < 2)
+    {
+        return {mean, 0.0};
+    }
+
+    double squares = 0.0;
+    for (double value : values)
+    {
+        squares += (value - mean) * (value - mean);
+    }
+    double stddev = std::sqrt(squares / (values.size() - 1));
+
+    return {mean, 1.96 * stddev / std::sqrt(static_cast<double>(values.size()))};
+}
+
+template<typename K>
+shards::SpatialSampler<K>::SpatialSampler(double rate, uint64_t seed, uint64_t modulus)
+    : seed_(seed), modulus_(modulus), threshold_(0)
+{
+    if (!(rate > 0.0 && rate <= 1.0))
+    {
+        throw ConfigurationException("Sampling rate must be in (0, 1]");
+    }
+    if (modulus_ == 0)
+    {
+        throw ConfigurationException("Sampling modulus must be > 0");
+    }
+
+    threshold_ = static_cast<uint64_t>(std::llround(rate * static_cast<double>(modulus_)));
+    if (threshold_ == 0)
+    {
+        throw ConfigurationException("Sampling rate is too small for modulus " + std::to_string(modulus_));
+    }
+}
+
+template<typename K>
+size_t shards::SpatialSampler<K>::scaleCacheSize(size_t cache_size) const
+{
+    double scaled = std::round(static_cast<double>(cache_size) * rate());
+    return std::max<size_t>(1, static_cast<size_t>(scaled));
+}
+
+template<typename K>
+std::vector<K> shards::SpatialSampler<K>::sample(const std::vector<K>& requests) const
+{
+    std::vector<K> sampled;
+    sampled.reserve(static_cast<size_t>(requests.size() * rate() * 1.1) + 16);
+
+    for (const K& key : requests)
+    {
+        if (keep(key))
+        {
+            sampled.push_back(key);
+        }
+    }
+
+    return sampled;
+}
+
+#endif // SHARDS_TPP
@@ -0,0 +1,108 @@
+/**
+ * @file StringArena.tpp
+ * @brief Реализация арены строковых ключей
+ */
+
+#ifndef STRINGARENA_TPP
+#define STRINGARENA_TPP
+
+#include "StringArena.h"
+#include <cstring>
+#include <stdexcept>
+
+inline keys::StringArena::StringArena()
+    : cursor_(nullptr), remaining_(0), live_count_(0), live_bytes_(0), reserved_bytes_(0)
+{}
+
+inline size_t keys::StringArena::classOf(size_t size)
+{
+    size_t size_class = kMinClass;
+    while ((size_t{1} << size_class) < size)
+    {
+        size_class++;
+    }
+    if (size_class >= kClasses)
+    {
+        throw std::length_error("String is too long for the arena");
+    }
+    return size_class;
+}
+
+inline char* keys::StringArena::allocate(size_t size_class)
+{
+    std::vector<char*>& free_list = free_[size_class];
+    if (!free_list.empty())
+    {
+        char* chunk = free_list.back();
+        free_list.pop_back();
+        return chunk;
+    }
+
+    const size_t chunk_size = size_t{1} << size_class;
+    if (chunk_size > kBlockSize / 4)
+    {
+        blocks_.push_back(std::make_unique<char[]>(chunk_size));
+        reserved_bytes_ += chunk_size;
+        return blocks_.back().get();
+    }
+
+    if (remaining_ < chunk_size)
+    {
+        // хвост старого блока раздается участками поменьше, чтобы он не пропадал
+        for (size_t tail_class = size_class; tail_class-- > kMinClass && remaining_ > 0;)
+        {
+            size_t tail_size = size_t{1} << tail_class;
+            if (remaining_ >= tail_size)
+            {
+                free_[tail_class].push_back(cursor_);
+                cursor_ += tail_size;
+                remaining_ -= tail_size;
+            }
+        }
+
+        blocks_.push_back(std::make_unique<char[]>(kBlockSize));
+        reserved_bytes_ += kBlockSize;
+        cursor_ = blocks_.back().get();
+        remaining_ = kBlockSize;
+    }
+
+    char* chunk = cursor_;
+    cursor_ += chunk_size;
+    remaining_ -= chunk_size;
+    return chunk;
+}
+
+inline std::string_view keys::StringArena::intern(std::string_view key)
+{
+    char* chunk = allocate(classOf(key.size()));
+    if (!key.empty())
+    {
+        std::memcpy(chunk, key.data(), key.size());
+    }
+    live_count_++;
+    live_bytes_ += key.size();
+    return std::string_view(chunk, key.size());
+}
+
+inline void keys::StringArena::release(std::string_view key)
+{
+    free_[classOf(key.size())].push_back(const_cast<char*>(key.data()));
+    live_count_--;
+    live_bytes_ -= key.size();
+}
+
+inline void keys::StringArena::clear()
+{
+    for (auto& free_list : free_)
+    {
+        free_list.clear();
+    }
+    blocks_.clear();
+    cursor_ = nullptr;
+    remaining_ = 0;
+    live_count_ = 0;
+    live_bytes_ = 0;
+    reserved_bytes_ = 0;
+}
+
+#endif // STRINGARENA_TPP
@@ -0,0 +1,79 @@
+/**
+ * @file TieredCache.tpp
+ * @brief Реализация двухуровневого кэша
+ */
+
+#ifndef TIEREDCACHE_TPP
+#define TIEREDCACHE_TPP
+
+#include "TieredCache.h"
+
+template<typename K, typename V, typename KeyPolicy>
+tier::TieredCache<K, V, KeyPolicy>::TieredCache(size_t memory_capacity, size_t disk_capacity,
+                                                const std::string& log_path, SlowGetFunc backend)
+    : backend_(std::move(backend)),
+      disk_(log_path, disk_capacity),
+      memory_(memory_capacity, [this](const K& key) { return load(key); }),
+      memory_hits_(0),
+      disk_hits_(0),
+      backend_loads_(0),
+      demotions_(0),
+      promoted_ttl_(0)
+{}
+
+template<typename K, typename V, typename KeyPolicy>
+V tier::TieredCache<K, V, KeyPolicy>::load(const K& key)
+{
+    V value;
+    uint64_t expire = 0;
+    if (disk_.take(key, value, &expire))
+    {
+        const uint64_t now = expire != 0 ? memory_.now() : 0;
+        if (expire == 0 || expire > now)
+        {
+            promoted_ttl_ = std::chrono::milliseconds(expire != 0 ? expire - now : 0);
+            disk_hits_++;
+            return value;
+        }
+    }
+
+    backend_loads_++;
+    return backend_(key);
+}
+
+template<typename K, typename V, typename KeyPolicy>
+V& tier::TieredCache<K, V, KeyPolicy>::get(const K& key)
+{
+    try
+    {
+        V& value = memory_.get(key);
+        memory_hits_++;
+        return value;
+    }
+    catch (const std::out_of_range&)
+    {
+    }
+
+    if (memory_.size() >= memory_.capacity())
+    {
+        // элемент с истекшим TTL освобождает место сам, его устаревшее значение в файл не пишется
+        bool expired = false;
+        uint64_t expire = 0;
+        auto victim = memory_.evict(expired, &expire);
+        if (!expired)
+        {
+            disk_.put(victim.first, victim.second, expire);
+            demotions_++;
+        }
+    }
+
+    promoted_ttl_ = std::chrono::milliseconds(0);
+    V& value = memory_.put(key);
+    if (promoted_ttl_.count() > 0)
+    {
+        memory_.setTTL(key, promoted_ttl_);
+    }
+    return value;
+}
+
+#endif // TIEREDCACHE_TPP
@@ -0,0 +1,277 @@
+/**
+ * @file Timeline.tpp
+ * @brief Реализация сбора и выгрузки статистики по окнам
+ */
+
+#ifndef TIMELINE_TPP
+#define TIMELINE_TPP
+
+#include "Timeline.h"
+#include <cstring>
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+
+inline size_t timeline::frequencyBin(int frequency)
+{
+    size_t bin = 0;
+    for (unsigned value = static_cast<unsigned>(std::max(frequency, 1)) >> 1; value != 0; value >>= 1)
+    {
+        bin++;
+    }
+    return std::min(bin, kFrequencyBins - 1);
+}
+
+inline double timeline::Timeline::hitRate(size_t row) const
+{
+    uint64_t requests = hits[row] + misses[row];
+    return requests == 0 ? 0.0 : static_cast<double>(hits[row]) / static_cast<double>(requests);
+}
+
+inline timeline::Recorder::Recorder(std::string policy, size_t window)
+    : requests_(0), window_requests_(0), window_hits_(0), last_occupancy_(0)
+{
+    if (window == 0)
+    {
+        throw std::invalid_argument("Timeline window must be greater than 0");
+    }
+    timeline_.policy = std::move(policy);
+    timeline_.window = window;
+}
+
+template<typename Cache>
+void timeline::Recorder::sample(const Cache& cache)
+{
+    uint64_t occupancy;
+    if constexpr (requires { cache.size(); })
+    {
+        occupancy = cache.size();
+    }
+    else
+    {
+        occupancy = cache.getCurrentSize();
+    }
+
+    uint64_t misses = window_requests_ - window_hits_;
+    uint64_t growth = occupancy > last_occupancy_ ? occupancy - last_occupancy_ : 0;
+
+    timeline_.end.push_back(requests_);
+    timeline_.hits.push_back(window_hits_);
+    timeline_.misses.push_back(misses);
+    timeline_.evictions.push_back(misses > growth ? misses - growth : 0);
+    timeline_.occupancy.push_back(occupancy);
+
+    int32_t min_frequency = -1;
+    if constexpr (requires { cache.forEachFrequency([](int, size_t) {}); })
+    {
+        std::array<uint64_t, kFrequencyBins> bins{};
+        int lowest = std::numeric_limits<int>::max();
+        cache.forEachFrequency([&](int frequency, size_t count)
+        {
+            bins[frequencyBin(frequency)] += count;
+            lowest = std::min(lowest, frequency);
+        });
+
+        for (size_t bin = 0; bin < kFrequencyBins; bin++)
+        {
+            timeline_.frequency_bins[bin].push_back(bins[bin]);
+        }
+        if (lowest != std::numeric_limits<int>::max())
+        {
+            min_frequency = lowest;
+        }
+    }
+    timeline_.min_frequency.push_back(min_frequency);
+
+    last_occupancy_ = occupancy;
+    window_requests_ = 0;
+    window_hits_ = 0;
+}
+
+template<typename Cache>
+void timeline::Recorder::finish(const Cache& cache)
+{
+    if (window_requests_ > 0)
+    {
+        sample(cache);
+    }
+}
+
+inline void timeline::writeCsv(const std::string& path, const std::vector<Timeline>& timelines)
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        throw StorageException("Cannot open timeline file " + path);
+    }
+
+    out << "policy,end,hit_rate,hits,misses,evictions,occupancy,min_frequency";
+    for (size_t bin = 0; bin < kFrequencyBins; bin++)
+    {
+        out << ",freq_" << (1u << bin) << (bin + 1 == kFrequencyBins ? "+" : "");
+    }
+    out << '\n';
+
+    out << std::fixed << std::setprecision(6);
+    for (const Timeline& timeline : timelines)
+    {
+        for (size_t row = 0; row < timeline.rows(); row++)
+        {
+            out << timeline.policy << ',' << timeline.end[row] << ',' << timeline.hitRate(row) << ','
+                << timeline.hits[row] << ',' << timeline.misses[row] << ',' << timeline.evictions[row] << ','
+                << timeline.occupancy[row] << ',' << timeline.min_frequency[row];
+            for (size_t bin = 0; bin < kFrequencyBins; bin++)
+            {
+                out << ',';
+                if (timeline.hasFrequencies())
+                {
+                    out << timeline.frequency_bins[bin][row];
+                }
+            }
+            out << '\n';
+        }
+    }
+
+    if (!out.flush())
+    {
+        throw StorageException("Failed to write timeline " + path);
+    }
+}
+
+inline void timeline::writeBinary(const std::string& path, const std::vector<Timeline>& timelines)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        throw StorageException("Cannot open timeline file " + path);
+    }
+
+    auto column = [&out](const auto& values)
+    {
+        out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(values[0]));
+    };
+
+    TimelineHeader header{};
+    std::memcpy(header.magic, kTimelineMagic, sizeof(header.magic));
+    header.version = kTimelineVersion;
+    header.frequency_bins = kFrequencyBins;
+    header.timelines = timelines.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const Timeline& timeline : timelines)
+    {
+        TimelineRecordHeader record{};
+        record.window = timeline.window;
+        record.rows = timeline.rows();
+        record.name_size = static_cast<uint32_t>(timeline.policy.size());
+        record.has_frequencies = timeline.hasFrequencies() ? 1 : 0;
+        out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        out.write(timeline.policy.data(), timeline.policy.size());
+
+        column(timeline.end);
+        column(timeline.hits);
+        column(timeline.misses);
+        column(timeline.evictions);
+        column(timeline.occupancy);
+        column(timeline.min_frequency);
+        if (record.has_frequencies)
+        {
+            for (const auto& bin : timeline.frequency_bins)
+            {
+                column(bin);
+            }
+        }
+    }
+
+    if (!out.flush())
+    {
+        throw StorageException("Failed to write timeline " + path);
+    }
+}
+
+inline std::vector<timeline::Timeline> timeline::readBinary(const std::string& path)
+{
+    storage::MappedFile file(path);
+    size_t offset = 0;
+
+    auto take = [&](void* dst, size_t bytes)
+    {
+        if (file.size() - offset < bytes)
+        {
+            throw StorageException("Timeline is truncated: " + path);
+        }
+        if (bytes == 0)
+        {
+            return;
+        }
+        std::memcpy(dst, file.data() + offset, bytes);
+        offset += bytes;
+    };
+    auto column = [&](auto& values, uint64_t rows)
+    {
+        if ((file.size() - offset) / sizeof(values[0]) < rows)
+        {
+            throw StorageException("Timeline is truncated: " + path);
+        }
+        values.resize(rows);
+        take(values.data(), rows * sizeof(values[0]));
+    };
+
+    TimelineHeader header;
+    take(&header, sizeof(header));
+    if (std::memcmp(header.magic, kTimelineMagic, sizeof(header.magic)) != 0 ||
+        header.version != kTimelineVersion || header.frequency_bins != kFrequencyBins)
+    {
+        throw StorageException("Unknown timeline format: " + path);
+    }
+
+    if ((file.size() - offset) / sizeof(TimelineRecordHeader) < header.timelines)
+    {
+        throw StorageException("Timeline is truncated: " + path);
+    }
+
+    std::vector<Timeline> timelines(header.timelines);
+    for (Timeline& timeline : timelines)
+    {
+        TimelineRecordHeader record;
+        take(&record, sizeof(record));
+        timeline.window = record.window;
+        timeline.policy.resize(record.name_size);
+        take(timeline.policy.data(), record.name_size);
+
+        column(timeline.end, record.rows);
+        column(timeline.hits, record.rows);
+        column(timeline.misses, record.rows);
+        column(timeline.evictions, record.rows);
+        column(timeline.occupancy, record.rows);
+        column(timeline.min_frequency, record.rows);
+        if (record.has_frequencies)
+        {
+            for (auto& bin : timeline.frequency_bins)
+            {
+                column(bin, record.rows);
+            }
+        }
+    }
+
+    if (offset != file.size())
+    {
+        throw StorageException("Timeline has trailing data: " + path);
+    }
+    return timelines;
+}
+
+inline void timeline::write(const std::string& path, const std::vector<Timeline>& timelines)
+{
+    const std::string csv = ".csv";
+    if (path.size() >= csv.size() && path.compare(path.size() - csv.size(), csv.size(), csv) == 0)
+    {
+        writeCsv(path, timelines);
+    }
+    else
+    {
+        writeBinary(path, timelines);
+    }
+}
+
+#endif // TIMELINE_TPP
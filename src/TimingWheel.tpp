@@ -0,0 +1,169 @@
+/**
+ * @file TimingWheel.tpp
+ * @brief Реализация иерархического колеса таймеров
+ */
+
+#ifndef TIMINGWHEEL_TPP
+#define TIMINGWHEEL_TPP
+
+#include "TimingWheel.h"
+
+template<typename K>
+timer::TimingWheel<K>::TimingWheel(uint64_t now) : now_(now), size_(0)
+{
+    level_sizes_.fill(0);
+}
+
+template<typename K>
+void timer::TimingWheel<K>::target(uint64_t expire, uint64_t earliest, uint8_t& level, uint8_t& slot) const
+{
+    uint64_t effective = expire > earliest ? expire : earliest;
+    uint64_t delta = effective - now_;
+
+    const uint64_t range = uint64_t(1) << (kLevelBits * kLevels);
+    if (delta >= range)
+    {
+        effective = now_ + range - 1;
+        delta = range - 1;
+    }
+
+    level = 0;
+    while (size_t(level) + 1 < kLevels && delta >= (uint64_t(1) << (kLevelBits * (level + 1))))
+    {
+        level++;
+    }
+    slot = static_cast<uint8_t>((effective >> (kLevelBits * level)) & (kSlots - 1));
+}
+
+template<typename K>
+void timer::TimingWheel<K>::place(Handle handle, uint64_t earliest)
+{
+    uint8_t level = 0;
+    uint8_t slot = 0;
+    target(handle->expire, earliest, level, slot);
+
+    std::list<Timer>& from = wheels_[handle->level][handle->slot];
+    std::list<Timer>& to = wheels_[level][slot];
+    to.splice(to.end(), from, handle);
+
+    level_sizes_[handle->level]--;
+    level_sizes_[level]++;
+    handle->level = level;
+    handle->slot = slot;
+}
+
+template<typename K>
+typename timer::TimingWheel<K>::Handle timer::TimingWheel<K>::schedule(const K& key, uint64_t expire)
+{
+    uint8_t level = 0;
+    uint8_t slot = 0;
+    target(expire, now_ + 1, level, slot);
+
+    std::list<Timer>& to = wheels_[level][slot];
+    to.push_back(Timer{key, expire, level, slot});
+    level_sizes_[level]++;
+    size_++;
+
+    return std::prev(to.end());
+}
+
+template<typename K>
+void timer::TimingWheel<K>::cancel(Handle handle)
+{
+    level_sizes_[handle->level]--;
+    size_--;
+    wheels_[handle->level][handle->slot].erase(handle);
+}
+
+template<typename K>
+void timer::TimingWheel<K>::cascade(size_t level, size_t slot)
+{
+    // слот текущего тика на нулевом уровне еще не разобран, поэтому таймеры со сроком
+    // на границе уровня остаются в нем и срабатывают в этот же тик
+    std::list<Timer>& list = wheels_[level][slot];
+    while (!list.empty())
+    {
+        place(list.begin(), now_);
+    }
+}
+
+template<typename K>
+template<typename OnExpire>
+size_t timer::TimingWheel<K>::advance(uint64_t now, OnExpire&& on_expire)
+{
+    size_t fired = 0;
+
+    while (now_ < now)
+    {
+        if (size_ == 0)
+        {
+            now_ = now;
+            break;
+        }
+
+        // до ближайшей границы самого нижнего непустого уровня ничего не срабатывает
+        size_t lowest = 0;
+        while (level_sizes_[lowest] == 0)
+        {
+            lowest++;
+        }
+        if (lowest > 0)
+        {
+            const uint64_t span = uint64_t(1) << (kLevelBits * lowest);
+            const uint64_t boundary = (now_ / span + 1) * span;
+            if (boundary > now)
+            {
+                now_ = now;
+                break;
+            }
+            now_ = boundary - 1;
+        }
+
+        now_++;
+
+        size_t top = 0;
+        while (top + 1 < kLevels && (now_ & ((uint64_t(1) << (kLevelBits * (top + 1))) - 1)) == 0)
+        {
+            top++;
+        }
+        for (size_t level = top; level > 0; level--)
+        {
+            cascade(level, (now_ >> (kLevelBits * level)) & (kSlots - 1));
+        }
+
+        std::list<Timer>& due = wheels_[0][now_ & (kSlots - 1)];
+        while (!due.empty())
+        {
+            Handle handle = due.begin();
+            if (handle->expire > now_)
+            {
+                // срок был дальше диапазона колеса
+                place(handle, now_ + 1);
+                continue;
+            }
+
+            K key = handle->key;
+            cancel(handle);
+            fired++;
+            on_expire(key);
+        }
+    }
+
+    return fired;
+}
+
+template<typename K>
+void timer::TimingWheel<K>::clear()
+{
+    for (auto& level : wheels_)
+    {
+        for (auto& slot : level)
+        {
+            slot.clear();
+        }
+    }
+    level_sizes_.fill(0);
+    size_ = 0;
+}
+
+#endif // TIMINGWHEEL_TPP
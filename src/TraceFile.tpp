@@ -0,0 +1,192 @@
+/**
+ * @file TraceFile.tpp
+ * @brief Реализация чтения и записи трасс
+ */
+
+#ifndef TRACEFILE_TPP
+#define TRACEFILE_TPP
+
+#include "TraceFile.h"
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+inline trace::TraceWriter::TraceWriter(const std::string& path, bool text)
+    : path_(path), text_(text), count_(0)
+{
+    out_.open(path, text ? std::ios::trunc : std::ios::binary | std::ios::trunc);
+    if (!out_)
+    {
+        throw StorageException("Cannot open trace file " + path);
+    }
+
+    if (!text_)
+    {
+        TraceHeader header{};
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    buffer_.reserve(1 << 16);
+}
+
+inline trace::TraceWriter::~TraceWriter() noexcept
+{
+    if (out_.is_open())
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+}
+
+inline void trace::TraceWriter::flushBuffer()
+{
+    if (text_)
+    {
+        for (int32_t key : buffer_)
+        {
+            out_ << key << '\n';
+        }
+    }
+    else
+    {
+        out_.write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size() * sizeof(int32_t));
+    }
+    buffer_.clear();
+}
+
+inline void trace::TraceWriter::write(int32_t key)
+{
+    buffer_.push_back(key);
+    count_++;
+    if (buffer_.size() == buffer_.capacity())
+    {
+        flushBuffer();
+    }
+}
+
+inline void trace::TraceWriter::write(const std::vector<int>& keys)
+{
+    for (int key : keys)
+    {
+        write(key);
+    }
+}
+
+inline void trace::TraceWriter::close()
+{
+    flushBuffer();
+
+    if (!text_)
+    {
+        TraceHeader header{};
+        std::memcpy(header.magic, kTraceMagic, sizeof(header.magic));
+        header.version = kTraceVersion;
+        header.key_size = sizeof(int32_t);
+        header.count = count_;
+        out_.seekp(0);
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    out_.flush();
+    bool ok = static_cast<bool>(out_);
+    out_.close();
+    if (!ok)
+    {
+        throw StorageException("Failed to write trace " + path_);
+    }
+}
+
+inline trace::TraceReader::TraceReader(const std::string& path) : path_(path), count_(0), offset_(0)
+{
+    char magic[sizeof(kTraceMagic)] = {};
+    {
+        std::ifstream probe(path, std::ios::binary);
+        if (!probe)
+        {
+            throw StorageException("Cannot open trace file " + path);
+        }
+        probe.read(magic, sizeof(magic));
+    }
+
+    if (std::memcmp(magic, kTraceMagic, sizeof(magic)) != 0)
+    {
+        text_.open(path);
+        return;
+    }
+
+    file_ = std::make_unique<storage::MappedFile>(path);
+
+    TraceHeader header;
+    if (file_->size() < sizeof(header))
+    {
+        throw StorageException("Trace is truncated: " + path);
+    }
+    std::memcpy(&header, file_->data(), sizeof(header));
+
+    if (header.version != kTraceVersion || header.key_size != sizeof(int32_t))
+    {
+        throw StorageException("Unknown trace format: " + path);
+    }
+    if (file_->size() != sizeof(header) + header.count * sizeof(int32_t))
+    {
+        throw StorageException("Trace size does not match record count: " + path);
+    }
+    count_ = header.count;
+}
+
+inline size_t trace::TraceReader::read(std::vector<int>& chunk, size_t max_size)
+{
+    chunk.clear();
+
+    if (file_ != nullptr)
+    {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(max_size, count_ - offset_));
+        chunk.resize(n);
+        std::memcpy(chunk.data(), file_->data() + sizeof(TraceHeader) + offset_ * sizeof(int32_t), n * sizeof(int32_t));
+        offset_ += n;
+        return n;
+    }
+
+    long long key = 0;
+    while (chunk.size() < max_size && text_ >> key)
+    {
+        if (key < std::numeric_limits<int32_t>::min() || key > std::numeric_limits<int32_t>::max())
+        {
+            throw StorageException("Trace key out of range in " + path_);
+        }
+        chunk.push_back(static_cast<int>(key));
+    }
+    if (chunk.size() < max_size && !text_.eof())
+    {
+        throw StorageException("Malformed text trace " + path_ + " after " + std::to_string(offset_ + chunk.size()) + " keys");
+    }
+    offset_ += chunk.size();
+    return chunk.size();
+}
+
+inline std::vector<int> trace::readTrace(const std::string& path)
+{
+    TraceReader reader(path);
+    std::vector<int> requests;
+    requests.reserve(static_cast<size_t>(reader.count()));
+
+    std::vector<int> chunk;
+    while (reader.read(chunk, 1 << 20) > 0)
+    {
+        requests.insert(requests.end(), chunk.begin(), chunk.end());
+    }
+    return requests;
+}
+
+inline void trace::writeTrace(const std::string& path, const std::vector<int>& requests, bool text)
+{
+    TraceWriter writer(path, text);
+    writer.write(requests);
+    writer.close();
+}
+
+#endif // TRACEFILE_TPP
@@ -0,0 +1,503 @@
+/**
+ * @file TraceStats.tpp
+ * @brief Реализация потоковых оценок свойств трассы
+ */
+
+#ifndef TRACESTATS_TPP
+#define TRACESTATS_TPP
+
+#include "TraceStats.h"
+#include <cmath>
+#include <algorithm>
+#include <string>
+
+template<typename K>
+stats::HyperLogLog<K>::HyperLogLog(unsigned precision) : precision_(precision)
+{
+    if (precision_ < 4 || precision_ > 18)
+    {
+        throw ConfigurationException("HyperLogLog precision must be in [4, 18]");
+    }
+    registers_.assign(size_t(1) << precision_, 0);
+}
+
+template<typename K>
+void stats::HyperLogLog<K>::add(const K& key)
+{
+    uint64_t hash = shards::mix64(static_cast<uint64_t>(std::hash<K>{}(key)));
+    size_t index = static_cast<size_t>(hash >> (64 - precision_));
+    uint64_t rest = hash << precision_;
+
+    const uint8_t max_rank = static_cast<uint8_t>(64 - precision_ + 1);
+    uint8_t rank = rest == 0 ? max_rank : static_cast<uint8_t>(std::min<int>(__builtin_clzll(rest) + 1, max_rank));
+
+    if (rank > registers_[index])
+    {
+        registers_[index] = rank;
+    }
+}
+
+template<typename K>
+void stats::HyperLogLog<K>::merge(const HyperLogLog& other)
+{
+    if (other.precision_ != precision_)
+    {
+        throw ConfigurationException("Cannot merge HyperLogLog sketches of different precision");
+    }
+    for (size_t i = 0; i < registers_.size(); i++)
+    {
+        registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+}
+
+template<typename K>
+double stats::HyperLogLog<K>::estimate() const
+{
+    const double m = static_cast<double>(registers_.size());
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (uint8_t reg : registers_)
+    {
+        sum += std::ldexp(1.0, -static_cast<int>(reg));
+        zeros += reg == 0;
+    }
+
+    const double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double raw = alpha * m * m / sum;
+
+    // на малых мощностях точнее линейный счет пустых регистров
+    if (raw <= 2.5 * m && zeros > 0)
+    {
+        return m * std::log(m / static_cast<double>(zeros));
+    }
+    return raw;
+}
+
+template<typename K>
+double stats::HyperLogLog<K>::relativeError() const
+{
+    return 1.04 / std::sqrt(static_cast<double>(registers_.size()));
+}
+
+template<typename K>
+stats::SpaceSaving<K>::SpaceSaving(size_t capacity) : capacity_(capacity)
+{
+    if (capacity_ == 0)
+    {
+        throw ConfigurationException("Space-Saving capacity must be > 0");
+    }
+    heap_.reserve(capacity_);
+    index_.reserve(capacity_);
+}
+
+template<typename K>
+void stats::SpaceSaving<K>::swapNodes(size_t a, size_t b)
+{
+    std::swap(heap_[a], heap_[b]);
+    index_[heap_[a].key] = a;
+    index_[heap_[b].key] = b;
+}
+
+template<typename K>
+void stats::SpaceSaving<K>::siftUp(size_t i)
+{
+    while (i > 0)
+    {
+        size_t parent = (i - 1) / 2;
+        if (heap_[parent].count <= heap_[i].count)
+        {
+            break;
+        }
+        swapNodes(i, parent);
+        i = parent;
+    }
+}
+
+template<typename K>
+void stats::SpaceSaving<K>::siftDown(size_t i)
+{
+    const size_t n = heap_.size();
+    while (true)
+    {
+        size_t smallest = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        if (left < n && heap_[left].count < heap_[smallest].count)
+        {
+            smallest = left;
+        }
+        if (right < n && heap_[right].count < heap_[smallest].count)
+        {
+            smallest = right;
+        }
+        if (smallest == i)
+        {
+            break;
+        }
+        swapNodes(i, smallest);
+        i = smallest;
+    }
+}
+
+template<typename K>
+void stats::SpaceSaving<K>::add(const K& key)
+{
+    auto it = index_.find(key);
+    if (it != index_.end())
+    {
+        heap_[it->second].count++;
+        siftDown(it->second);
+        return;
+    }
+
+    if (heap_.size() < capacity_)
+    {
+        heap_.push_back(Counter{key, 1, 0});
+        index_[key] = heap_.size() - 1;
+        siftUp(heap_.size() - 1);
+        return;
+    }
+
+    // новый ключ занимает наименьший счетчик и наследует его значение как ошибку
+    Counter& root = heap_[0];
+    index_.erase(root.key);
+    root.error = root.count;
+    root.count++;
+    root.key = key;
+    index_[key] = 0;
+    siftDown(0);
+}
+
+template<typename K>
+uint64_t stats::SpaceSaving<K>::minCount() const
+{
+    return heap_.size() < capacity_ ? 0 : heap_[0].count;
+}
+
+template<typename K>
+void stats::SpaceSaving<K>::merge(const SpaceSaving& other)
+{
+    const uint64_t own_min = minCount();
+    const uint64_t other_min = other.minCount();
+
+    std::unordered_map<K, Counter> combined;
+    combined.reserve(heap_.size() + other.heap_.size());
+
+    for (const Counter& counter : heap_)
+    {
+        combined.emplace(counter.key, Counter{counter.key, counter.count + other_min, counter.error + other_min});
+    }
+    for (const Counter& counter : other.heap_)
+    {
+        auto it = combined.find(counter.key);
+        if (it == combined.end())
+        {
+            combined.emplace(counter.key, Counter{counter.key, counter.count + own_min, counter.error + own_min});
+        }
+        else
+        {
+            // ключ есть в обеих сводках: вместо минимума другой сводки - ее точный счетчик
+            it->second.count += counter.count - other_min;
+            it->second.error += counter.error - other_min;
+        }
+    }
+
+    std::vector<Counter> counters;
+    counters.reserve(combined.size());
+    for (auto& entry : combined)
+    {
+        counters.push_back(entry.second);
+    }
+    if (counters.size() > capacity_)
+    {
+        std::nth_element(counters.begin(), counters.begin() + capacity_, counters.end(),
+                         [](const Counter& a, const Counter& b) { return a.count > b.count; });
+        counters.resize(capacity_);
+    }
+
+    heap_ = std::move(counters);
+    index_.clear();
+    for (size_t i = 0; i < heap_.size(); i++)
+    {
+        index_[heap_[i].key] = i;
+    }
+    for (size_t i = heap_.size() / 2; i-- > 0;)
+    {
+        siftDown(i);
+    }
+}
+
+template<typename K>
+std::vector<typename stats::SpaceSaving<K>::Counter> stats::SpaceSaving<K>::top() const
+{
+    std::vector<Counter> sorted = heap_;
+    std::sort(sorted.begin(), sorted.end(), [](const Counter& a, const Counter& b) { return a.count > b.count; });
+    return sorted;
+}
+
+template<typename K>
+std::vector<uint64_t> stats::SpaceSaving<K>::reliableCounts() const
+{
+    std::vector<uint64_t> counts;
+    for (const Counter& counter : top())
+    {
+        if (counter.error * 2 >= counter.count)
+        {
+            break;
+        }
+        counts.push_back(counter.count - counter.error);
+    }
+    return counts;
+}
+
+inline double stats::fitZipf(const std::vector<uint64_t>& counts)
+{
+    double sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_xy = 0.0;
+    size_t n = 0;
+
+    for (size_t rank = 0; rank < counts.size(); rank++)
+    {
+        if (counts[rank] == 0)
+        {
+            continue;
+        }
+        double x = std::log(static_cast<double>(rank + 1));
+        double y = std::log(static_cast<double>(counts[rank]));
+        sum_x += x;
+        sum_y += y;
+        sum_xx += x * x;
+        sum_xy += x * y;
+        n++;
+    }
+
+    double denominator = n * sum_xx - sum_x * sum_x;
+    if (n < 2 || denominator <= 0.0)
+    {
+        return 0.0;
+    }
+    return -(n * sum_xy - sum_x * sum_y) / denominator;
+}
+
+inline void stats::FenwickTree::add(size_t index, int64_t delta)
+{
+    for (size_t i = index + 1; i < tree_.size(); i += i & (~i + 1))
+    {
+        tree_[i] += delta;
+    }
+}
+
+inline int64_t stats::FenwickTree::prefix(size_t end) const
+{
+    int64_t sum = 0;
+    for (size_t i = end; i > 0; i -= i & (~i + 1))
+    {
+        sum += tree_[i];
+    }
+    return sum;
+}
+
+inline void stats::FenwickTree::assign(const std::vector<int64_t>& values)
+{
+    tree_.assign(values.size() + 1, 0);
+    for (size_t i = 1; i < tree_.size(); i++)
+    {
+        tree_[i] += values[i - 1];
+        size_t parent = i + (i & (~i + 1));
+        if (parent < tree_.size())
+        {
+            tree_[parent] += tree_[i];
+        }
+    }
+}
+
+template<typename K>
+stats::ReuseProfiler<K>::ReuseProfiler(ReuseOptions options)
+    : options_(std::move(options)), seed_(options_.seed), threshold_(0),
+      marks_(options_.initial_positions), position_time_(options_.initial_positions, 0),
+      cursor_(0), compactions_(0), histogram_(1, 0.0), cold_(0.0), references_(0.0),
+      window_sum_(options_.windows.size(), 0.0), window_max_(options_.windows.size(), 0.0), window_weight_(0.0)
+{
+    if (!(options_.rate > 0.0 && options_.rate <= 1.0))
+    {
+        throw ConfigurationException("Sampling rate must be in (0, 1]");
+    }
+    if (options_.max_tracked == 0)
+    {
+        throw ConfigurationException("Sample size limit must be > 0");
+    }
+    if (options_.initial_positions < 2)
+    {
+        throw ConfigurationException("Initial positions must be >= 2");
+    }
+    for (uint64_t window : options_.windows)
+    {
+        if (window == 0)
+        {
+            throw ConfigurationException("Working set windows must be > 0");
+        }
+    }
+
+    threshold_ = static_cast<uint64_t>(std::llround(options_.rate * static_cast<double>(kModulus)));
+    if (threshold_ == 0)
+    {
+        throw ConfigurationException("Sampling rate is too small for modulus " + std::to_string(kModulus));
+    }
+}
+
+template<typename K>
+uint64_t stats::ReuseProfiler<K>::slotOf(const K& key) const
+{
+    return shards::mix64(static_cast<uint64_t>(std::hash<K>{}(key)) ^ shards::mix64(seed_)) % kModulus;
+}
+
+template<typename K>
+size_t stats::ReuseProfiler<K>::binOf(double distance)
+{
+    if (distance < 1.0)
+    {
+        return 0;
+    }
+    return static_cast<size_t>(std::floor(std::log2(distance))) + 1;
+}
+
+template<typename K>
+void stats::ReuseProfiler<K>::compact()
+{
+    std::vector<std::pair<size_t, Entry*>> live;
+    live.reserve(tracked_.size());
+    for (auto& entry : tracked_)
+    {
+        live.emplace_back(entry.second.position, &entry.second);
+    }
+    std::sort(live.begin(), live.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    const size_t new_size = std::max(options_.initial_positions, 4 * live.size() + 2);
+    std::vector<int64_t> values(new_size, 0);
+    std::vector<uint64_t> times(new_size, 0);
+
+    for (size_t i = 0; i < live.size(); i++)
+    {
+        times[i] = position_time_[live[i].first];
+        values[i] = 1;
+        live[i].second->position = i;
+    }
+
+    marks_.assign(values);
+    position_time_ = std::move(times);
+    cursor_ = live.size();
+    compactions_++;
+}
+
+template<typename K>
+void stats::ReuseProfiler<K>::shrinkSample()
+{
+    while (tracked_.size() > options_.max_tracked && by_slot_.top().first > 0)
+    {
+        threshold_ = by_slot_.top().first;
+
+        while (!by_slot_.empty() && by_slot_.top().first >= threshold_)
+        {
+            auto it = tracked_.find(by_slot_.top().second);
+            marks_.add(it->second.position, -1);
+            tracked_.erase(it);
+            by_slot_.pop();
+        }
+    }
+}
+
+template<typename K>
+void stats::ReuseProfiler<K>::access(const K& key, uint64_t time)
+{
+    uint64_t slot = slotOf(key);
+    if (slot >= threshold_)
+    {
+        return;
+    }
+
+    const double scale = 1.0 / rate();
+    references_ += scale;
+
+    if (cursor_ == marks_.size())
+    {
+        compact();
+    }
+
+    auto it = tracked_.find(key);
+    if (it == tracked_.end())
+    {
+        cold_ += scale;
+        tracked_.emplace(key, Entry{cursor_, 1});
+        by_slot_.emplace(slot, key);
+    }
+    else
+    {
+        size_t previous = it->second.position;
+        double distance = static_cast<double>(marks_.range(previous + 1, cursor_)) * scale;
+
+        size_t bin = binOf(distance);
+        if (bin >= histogram_.size())
+        {
+            histogram_.resize(bin + 1, 0.0);
+        }
+        histogram_[bin] += scale;
+
+        marks_.add(previous, -1);
+        it->second.position = cursor_;
+        it->second.references++;
+    }
+
+    marks_.add(cursor_, 1);
+    position_time_[cursor_] = time;
+    cursor_++;
+
+    // позиции упорядочены по времени, поэтому начало окна ищется двоичным поиском
+    for (size_t w = 0; w < options_.windows.size(); w++)
+    {
+        const uint64_t window = options_.windows[w];
+        size_t begin = 0;
+        if (time >= window)
+        {
+            begin = static_cast<size_t>(std::upper_bound(position_time_.begin(), position_time_.begin() + cursor_,
+                                                         time - window) - position_time_.begin());
+        }
+        double working_set = static_cast<double>(marks_.range(begin, cursor_)) * scale;
+        window_sum_[w] += working_set * scale;
+        window_max_[w] = std::max(window_max_[w], working_set);
+    }
+    window_weight_ += scale;
+
+    if (tracked_.size() > options_.max_tracked)
+    {
+        shrinkSample();
+    }
+}
+
+template<typename K>
+double stats::ReuseProfiler<K>::oneHitFraction() const
+{
+    if (tracked_.empty())
+    {
+        return 0.0;
+    }
+
+    size_t once = 0;
+    for (const auto& entry : tracked_)
+    {
+        once += entry.second.references == 1;
+    }
+    return static_cast<double>(once) / static_cast<double>(tracked_.size());
+}
+
+template<typename K>
+std::vector<typename stats::ReuseProfiler<K>::WindowStats> stats::ReuseProfiler<K>::workingSets() const
+{
+    std::vector<WindowStats> result;
+    for (size_t w = 0; w < options_.windows.size(); w++)
+    {
+        double mean = window_weight_ == 0.0 ? 0.0 : window_sum_[w] / window_weight_;
+        result.push_back(WindowStats{options_.windows[w], mean, window_max_[w]});
+    }
+    return result;
+}
+
+#endif // TRACESTATS_TPP
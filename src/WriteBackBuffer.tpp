@@ -0,0 +1,241 @@
+/**
+ * @file WriteBackBuffer.tpp
+ * @brief Реализация буфера отложенной записи
+ */
+
+#ifndef WRITEBACKBUFFER_TPP
+#define WRITEBACKBUFFER_TPP
+
+#include "WriteBackBuffer.h"
+#include <algorithm>
+
+template<typename K, typename V>
+lfu::WriteBackBuffer<K, V>::WriteBackBuffer(BatchWriter writer, size_t batch_size, Clock::duration flush_deadline)
+    : writer_(std::move(writer)),
+      batch_size_(batch_size),
+      flush_deadline_(flush_deadline),
+      writing_(false),
+      flush_requested_(false),
+      stop_(false),
+      batches_written_(0),
+      entries_written_(0),
+      coalesced_(0)
+{
+    if (batch_size_ == 0)
+    {
+        throw ConfigurationException("Write-back batch size must be > 0");
+    }
+
+    worker_ = std::thread([this] { run(); });
+}
+
+template<typename K, typename V>
+lfu::WriteBackBuffer<K, V>::~WriteBackBuffer() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    worker_.join();
+}
+
+template<typename K, typename V>
+void lfu::WriteBackBuffer<K, V>::onEvict(const K& key, const V& value, bool dirty)
+{
+    if (!dirty)
+    {
+        return;
+    }
+
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        wake = pending_.empty();
+
+        // замененное значение сохраняет место в очереди и срок: оно ждет с первого вытеснения
+        auto it = pending_index_.find(key);
+        if (it != pending_index_.end())
+        {
+            it->second->value = value;
+            coalesced_++;
+        }
+        else
+        {
+            pending_.push_back(Pending{key, value, Clock::now()});
+            pending_index_.emplace(key, std::prev(pending_.end()));
+        }
+
+        wake = wake || pending_.size() >= batch_size_;
+    }
+
+    if (wake)
+    {
+        work_cv_.notify_one();
+    }
+}
+
+template<typename K, typename V>
+void lfu::WriteBackBuffer<K, V>::takeBatch()
+{
+    in_flight_.clear();
+    in_flight_index_.clear();
+    in_flight_.reserve(std::min(batch_size_, pending_.size()));
+
+    while (!pending_.empty() && in_flight_.size() < batch_size_)
+    {
+        Pending& entry = pending_.front();
+        pending_index_.erase(entry.key);
+        in_flight_index_.emplace(entry.key, in_flight_.size());
+        in_flight_.emplace_back(std::move(entry.key), std::move(entry.value));
+        pending_.pop_front();
+    }
+}
+
+template<typename K, typename V>
+std::optional<V> lfu::WriteBackBuffer<K, V>::lookup(const K& key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // в буфере значение новее записываемого
+    auto it = pending_index_.find(key);
+    if (it != pending_index_.end())
+    {
+        return it->second->value;
+    }
+
+    auto in_flight = in_flight_index_.find(key);
+    if (in_flight != in_flight_index_.end())
+    {
+        return in_flight_[in_flight->second].second;
+    }
+    return std::nullopt;
+}
+
+template<typename K, typename V>
+void lfu::WriteBackBuffer<K, V>::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true)
+    {
+        if (pending_.empty())
+        {
+            flush_requested_ = false;
+            idle_cv_.notify_all();
+
+            if (stop_)
+            {
+                return;
+            }
+            work_cv_.wait(lock);
+            continue;
+        }
+
+        bool ready = stop_ || flush_requested_ || pending_.size() >= batch_size_;
+        if (!ready && work_cv_.wait_until(lock, pending_.front().enqueued + flush_deadline_) == std::cv_status::no_timeout)
+        {
+            continue;
+        }
+
+        takeBatch();
+        writing_ = true;
+        lock.unlock();
+
+        // пока идет запись, in_flight_ только читается: lookup() под блокировкой, writer без нее
+        std::exception_ptr error;
+        try
+        {
+            writer_(in_flight_);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        writing_ = false;
+        Batch batch = std::move(in_flight_);
+        in_flight_.clear();
+        in_flight_index_.clear();
+
+        if (error)
+        {
+            error_ = error;
+            if (stop_)
+            {
+                continue;
+            }
+
+            // элементы возвращаются в буфер (если их не заменили более новые) и ждут следующего срока
+            const Clock::time_point now = Clock::now();
+            for (auto& entry : batch)
+            {
+                if (pending_index_.find(entry.first) == pending_index_.end())
+                {
+                    pending_.push_back(Pending{std::move(entry.first), std::move(entry.second), now});
+                    pending_index_.emplace(pending_.back().key, std::prev(pending_.end()));
+                }
+            }
+            flush_requested_ = false;
+            idle_cv_.notify_all();
+            continue;
+        }
+
+        batches_written_++;
+        entries_written_ += batch.size();
+    }
+}
+
+template<typename K, typename V>
+void lfu::WriteBackBuffer<K, V>::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // уже начатая запись тоже ждется: иначе предикат ниже выполнен сразу и flush() вернется раньше нее
+    if (!pending_.empty() || writing_)
+    {
+        flush_requested_ = true;
+        work_cv_.notify_one();
+    }
+
+    idle_cv_.wait(lock, [this] { return (pending_.empty() && !writing_) || !flush_requested_; });
+
+    if (error_)
+    {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+template<typename K, typename V>
+size_t lfu::WriteBackBuffer<K, V>::pendingCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+template<typename K, typename V>
+size_t lfu::WriteBackBuffer<K, V>::batchesWritten()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batches_written_;
+}
+
+template<typename K, typename V>
+size_t lfu::WriteBackBuffer<K, V>::entriesWritten()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_written_;
+}
+
+template<typename K, typename V>
+size_t lfu::WriteBackBuffer<K, V>::coalescedCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return coalesced_;
+}
+
+#endif // WRITEBACKBUFFER_TPP
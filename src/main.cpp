@@ -12,12 +12,29 @@
 #include <map>
 #include <cmath>
 #include <memory>
+#include <chrono>
+#include <filesystem>
+#include <sstream>
 
+#include <malloc.h>
+
+#include "ArgMax.h"
 #include "LFUCache.h"
+#include "LRUCache.h"
 #include "OptimalCache.h"
+#include "NextUseIndex.h"
+#include "GDSFCache.h"
+#include "InternedCache.h"
+#include "CompactLFUCache.h"
+#include "Shards.h"
+#include "PartitionedCache.h"
+#include "TieredCache.h"
+#include "TraceFile.h"
+#include "Timeline.h"
 #include "global.h"
 #include "exceptions/ConfigurationException.h"
 #include "exceptions/BenchmarkException.h"
+#include "exceptions/StorageException.h"
 
 
 
@@ -103,21 +120,25 @@ std::vector<int> generateSequentialRequests(int num_requests, int num_pages)
 
 /**
  * @brief Тестирует LFU кэш
+ * @tparam KeyPolicy Политика хранения ключей
  * @param cache_size Размер кэша
  * @param requests Последовательность запросов
+ * @param recorder Сборщик статистики по окнам (nullptr - без нее)
  * @return hit rate 
  * 
  * @throws CacheOperationException если ошибка
  */
-double testLFUCache(size_t cache_size, const std::vector<int>& requests)
+template<typename KeyPolicy = keys::HashKeys>
+double testLFUCache(size_t cache_size, const std::vector<int>& requests, timeline::Recorder* recorder = nullptr)
 {
     try
     {
-        lfu::LFUCache<int, int> cache(cache_size, slow_get_page_int);
+        lfu::LFUCache<int, int, KeyPolicy> cache(cache_size, slow_get_page_int);
         int hits = 0;
         
         for (int page : requests)
         {
+            bool hit = true;
             try
             {
                 cache.get(page);
@@ -128,8 +149,19 @@ double testLFUCache(size_t cache_size, const std::vector<int>& requests)
             {
                 //std::cout << "miss page " << page << std::endl;
                 cache.put(page);
+                hit = false;
+            }
+
+            if (recorder)
+            {
+                recorder->access(hit, cache);
             }
         }
+
+        if (recorder)
+        {
+            recorder->finish(cache);
+        }
         
         return static_cast<double>(hits) / requests.size();
     }
@@ -139,20 +171,94 @@ double testLFUCache(size_t cache_size, const std::vector<int>& requests)
     }
 }
 
+/**
+ * @brief Тестирует LRU кэш
+ * @tparam KeyPolicy Политика хранения ключей
+ * @param cache_size Размер кэша
+ * @param requests Последовательность запросов
+ * @param recorder Сборщик статистики по окнам (nullptr - без нее)
+ * @return hit rate 
+ * 
+ * @throws CacheOperationException если ошибка
+ */
+template<typename KeyPolicy = keys::HashKeys>
+double testLRUCache(size_t cache_size, const std::vector<int>& requests, timeline::Recorder* recorder = nullptr)
+{
+    try
+    {
+        lru::LRUCache<int, int, KeyPolicy> cache(cache_size, slow_get_page_int);
+        int hits = 0;
+        
+        for (int page : requests)
+        {
+            bool hit = true;
+            try
+            {
+                cache.get(page);
+                hits++;
+            }
+            catch (const std::out_of_range&)
+            {
+                cache.put(page);
+                hit = false;
+            }
+
+            if (recorder)
+            {
+                recorder->access(hit, cache);
+            }
+        }
+
+        if (recorder)
+        {
+            recorder->finish(cache);
+        }
+        
+        return static_cast<double>(hits) / requests.size();
+    }
+    catch (const std::exception& e)
+    {
+        throw CacheOperationException(std::string("LRU cache test failed: ") + e.what());
+    }
+}
+
 /**
  * @brief Тестирует оптимальный кэш
+ * @tparam KeyPolicy Политика хранения ключей
  * @param cache_size Размер кэша
  * @param requests Последовательность запросов
+ * @param recorder Сборщик статистики по окнам (nullptr - без нее)
+ * @param index Готовый индекс следующего обращения для этой трассы (nullptr - построить)
  * @return hit rate
  * 
  * @throws CacheOperationException если ошибка
  */
-double testOptimalCache(size_t cache_size, const std::vector<int>& requests)
+template<typename KeyPolicy = keys::HashKeys>
+double testOptimalCache(size_t cache_size, const std::vector<int>& requests, timeline::Recorder* recorder = nullptr,
+                        std::shared_ptr<const opt::NextUseIndex> index = nullptr)
 {
     try
     {
-        opt::OptimalCache<int, int> optimal(cache_size, slow_get_page_int);
-        optimal.preprocessRequests(requests);
+        opt::OptimalCache<int, int, KeyPolicy> optimal(cache_size, slow_get_page_int);
+        if (index)
+        {
+            optimal.setNextUseIndex(std::move(index));
+        }
+        else
+        {
+            optimal.preprocessRequests(requests);
+        }
+
+        if (recorder)
+        {
+            for (int page : requests)
+            {
+                recorder->access(optimal.step(page), optimal);
+            }
+            recorder->finish(optimal);
+            return optimal.getHitRate();
+        }
+
         size_t hits = optimal.simulate(requests);
         return static_cast<double>(hits) / requests.size();
     }
@@ -168,13 +274,15 @@ double testOptimalCache(size_t cache_size, const std::vector<int>& requests)
  * @param max_cache_size Максимальный размер кэша
  * @param step Шаг размера
  * @param requests Последовательность запросов
+ * @param index Индекс следующего обращения для requests (nullptr - построить один раз на все размеры)
  * @return Вектор результатов
  * 
  * @throws BenchmarkException если параметры некорректны
  * @throws CacheOperationException если ошибка
  */
 std::vector<BenchmarkResult> runBenchmark(size_t min_cache_size, size_t max_cache_size, 
-                                     size_t step, const std::vector<int>& requests) //NOTE - нужны тесты
+                                     size_t step, const std::vector<int>& requests,
+                                     std::shared_ptr<const opt::NextUseIndex> index = nullptr) //NOTE - нужны тесты
 {
     if (min_cache_size == 0)
     {
@@ -193,6 +301,11 @@ std::vector<BenchmarkResult> runBenchmark(size_t min_cache_size, size_t max_cach
         throw BenchmarkException("Request sequence is empty");
     }
     
+    if (!index)
+    {
+        index = opt::NextUseIndex::build(requests);
+    }
+    
     std::vector<BenchmarkResult> results;
     
     for (size_t cache_size = min_cache_size; cache_size <= max_cache_size; cache_size += step)
@@ -202,7 +315,7 @@ std::vector<BenchmarkResult> runBenchmark(size_t min_cache_size, size_t max_cach
             std::cout << "Testing cache size " << cache_size << "..." << std::endl;
             
             double lfu_hit_rate = testLFUCache(cache_size, requests);
-            double optimal_hit_rate = testOptimalCache(cache_size, requests);
+            double optimal_hit_rate = testOptimalCache(cache_size, requests, nullptr, index);
             
             results.emplace_back(cache_size, lfu_hit_rate * 100, optimal_hit_rate * 100);
             
@@ -257,253 +370,1462 @@ void printBenchmarkResults(const std::vector<BenchmarkResult>& results)
 
 
 
-void printHelp()
+/**
+ * @brief Параметры запуска симулятора
+ */
+struct SimulationParameters
 {
-    std::cout << "\nCompare lfu and optimal caches\n\n";
+    std::string mode = "compare";
+    int num_requests = 1000;
+    int num_pages = 100;
+    int cache_size = 10;
+    std::string request_type = "random";
 
-    std::cout << "Usage:\n";
-    std::cout << "  --mode=lfu              : Run only LFU cache simulation\n";
-    std::cout << "  --mode=optimal          : Run only Optimal cache simulation\n";
-    std::cout << "  --mode=compare          : Compare both (default)\n";
-    std::cout << "  --mode=benchmark        : Run benchmark\n\n";
-    
-    std::cout << "Simulation Parameters:\n";
-    std::cout << "  --requests=<number>     : Number of requests to generate (default: 1000)\n";
-    std::cout << "  --pages=<number>        : Number of unique pages (default: 100)\n";
-    std::cout << "  --cache-size=<number>   : Cache size for simulation (default: 10)\n";
-    std::cout << "  --request-type=<type>   : Type of requests (random/sequential, default: random)\n\n";
-    
-    std::cout << "Benchmark Parameters:\n";
-    std::cout << "  --min-size=<number>     : Minimum cache size (default: 5)\n";
-    std::cout << "  --max-size=<number>     : Maximum cache size (default: 50)\n";
-    std::cout << "  --step=<number>         : Step for cache size (default: 5)\n\n";
-}
+    int min_cache_size = 5;
+    int max_cache_size = 50;
+    int step = 5;
+
+    std::string snapshot_file = "lfu.snapshot";
+
+    double sample_rate = 0.1;
+    int shards_seeds = 5;
+    bool validate = false;
 
+    int tenants = 4;
+    int epoch = 1000;
 
-int getParameters(int argc, char** argv,
-                    std::string& mode,
-                    int& num_requests, int& num_pages, int& cache_size,
-                    std::string& request_type,
-                    int& min_cache_size, int& max_cache_size, int& step)
+    int disk_size = 0;
+    std::string tier_file = "lfu.tier";
+    double memory_cost = 1.0;
+    double disk_cost = 100.0;
+    double backend_cost = 10000.0;
+
+    double pressure = 0.75;
+
+    double cost_spread = 100.0;
+
+    std::string trace_file;
+    std::string save_trace;
+    bool index_cache = false;
+
+    std::string timeline_file;
+    int window = 1000;
+
+    bool help = false;
+};
+
+
+
+/**
+ * @brief Замеряет время сохранения и восстановления снимка LFU кэша
+ * @param cache_size Количество элементов в кэше
+ * @param path Путь к файлу снимка
+ * 
+ * @throws StorageException если ошибка ввода-вывода
+ */
+void runSnapshotBenchmark(size_t cache_size, const std::string& path)
 {
-    mode = "compare";
-    num_requests = 1000;
-    num_pages = 100;
-    cache_size = 10;
-    request_type = "random";
-    
-    min_cache_size = 5;
-    max_cache_size = 50;
-    step = 5;
-    
-    for (int i = 1; i < argc; ++i)
+    using Clock = std::chrono::steady_clock;
+
+    lfu::LFUCache<int, int> cache(cache_size, slow_get_page_int);
+    for (size_t i = 1; i <= cache_size; i++)
     {
-        std::string arg = argv[i];
-        
-        if (arg == "--help" || arg == "-h")
-        {
-            printHelp();
-            return 0;
-        }
-        else if (arg.substr(0, 7) == "--mode=")
-        {
-            mode = arg.substr(7);
-        }
-        else if (arg.substr(0, 11) == "--requests=")
-        {
-            num_requests = stoi(arg.substr(11));
-        }
-        else if (arg.substr(0, 8) == "--pages=")
-        {
-            num_pages = stoi(arg.substr(8));
-        }
-        else if (arg.substr(0, 13) == "--cache-size=")
+        cache.put(static_cast<int>(i));
+        if (i % 3 == 0)
         {
-            cache_size = stoul(arg.substr(13));
-        }
-        else if (arg.substr(0, 15) == "--request-type=")
-        {
-            request_type = arg.substr(15);
-        }
-        else if (arg.substr(0, 11) == "--min-size=")
-        {
-            min_cache_size = stoul(arg.substr(11));
-        }
-        else if (arg.substr(0, 11) == "--max-size=")
-        {
-            max_cache_size = stoul(arg.substr(11));
-        }
-        else if (arg.substr(0, 7) == "--step=")
-        {
-            step = stoul(arg.substr(7));
-        }
-        else
-        {
-            throw ConfigurationException("Unknown argument: " + arg);
+            cache.get(static_cast<int>(i));
         }
     }
-    
-    if (num_requests <= 0)
-    {
-        throw std::invalid_argument("Number of requests must be > 0: " + std::to_string(num_requests));
-    }
 
-    if (num_pages <= 0)
-    {
-        throw std::invalid_argument("Number of pages must be > 0: " + std::to_string(num_pages));
-    }
+    auto save_start = Clock::now();
+    cache.saveSnapshot(path);
+    auto save_end = Clock::now();
 
-    if (mode != "lfu" && mode != "optimal" && mode != "compare" && mode != "benchmark")
-    {
-        throw ConfigurationException("Invalid mode: " + mode);
-    }
+    lfu::LFUCache<int, int> restored(cache_size, slow_get_page_int);
 
-    if (request_type != "random" && request_type != "sequential")
-    {
-        throw ConfigurationException("Invalid request type");
-    }
+    auto load_start = Clock::now();
+    restored.loadSnapshot(path);
+    auto load_end = Clock::now();
 
-    if (mode != "benchmark" && cache_size == 0)
+    if (restored.size() != cache.size())
     {
-        throw std::invalid_argument("Cache size must be > 0");
+        throw BenchmarkException("Restored cache size differs from the saved one");
     }
 
-    if (mode == "benchmark")
-    {
-        if (min_cache_size <= 0)
-        {
-            throw std::invalid_argument("Minimum cache size must be greater than 0");
-        }
-        if (max_cache_size < min_cache_size)
-        {
-            throw std::invalid_argument("Maximum cache size must be >= minimum cache size");
-        }
-        if (step <= 0)
-        {
-            throw std::invalid_argument("Step must be greater than 0");
-        }
-    }
+    double save_ms = std::chrono::duration<double, std::milli>(save_end - save_start).count();
+    double load_ms = std::chrono::duration<double, std::milli>(load_end - load_start).count();
+    double file_mb = static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0);
 
-    return 0;
+    std::cout << "\nSnapshot benchmark" << std::endl;
+    std::cout << std::string(45, '=') << std::endl;
+    std::cout << std::left << std::setw(20) << "Entries:" << cache.size() << std::endl;
+    std::cout << std::setw(20) << "File size:" << std::fixed << std::setprecision(2) << file_mb << " MB" << std::endl;
+    std::cout << std::setw(20) << "Snapshot:" << save_ms << " ms" << std::endl;
+    std::cout << std::setw(20) << "Restore:" << load_ms << " ms" << std::endl;
+    std::cout << std::setw(20) << "Restore rate:" << (restored.size() / (load_ms / 1000.0)) / 1e6 << " M entries/s" << std::endl;
 }
 
-int main(int argc, char* argv[])
+
+
+/**
+ * @brief Сравнивает хеш-таблицы и прямую индексацию плотных ключей для обоих кэшей
+ * @param cache_size Размер кэша
+ * @param requests Последовательность запросов
+ * 
+ * @throws BenchmarkException если политики дали разный hit rate
+ */
+void runDenseKeyBenchmark(size_t cache_size, const std::vector<int>& requests)
 {
-    std::string mode = "";
-    int num_requests = 0;
-    int num_pages = 0;
-    int cache_size = 0;
-    std::string request_type = "";
-        
-    int min_cache_size = 0;
-    int max_cache_size = 0;
-    int step = 0;
-    
-    try
+    using Clock = std::chrono::steady_clock;
+
+    auto measure = [](auto&& func, double& hit_rate)
     {
-        getParameters(argc, argv, mode, num_requests, num_pages, cache_size,
-                    request_type, min_cache_size, max_cache_size, step);
+        auto start = Clock::now();
+        hit_rate = func();
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
 
+    double lfu_hash_rate = 0, lfu_dense_rate = 0, opt_hash_rate = 0, opt_dense_rate = 0;
 
+    double lfu_hash_ms  = measure([&] { return testLFUCache<keys::HashKeys>(cache_size, requests); }, lfu_hash_rate);
+    double lfu_dense_ms = measure([&] { return testLFUCache<keys::DenseKeys>(cache_size, requests); }, lfu_dense_rate);
+    double opt_hash_ms  = measure([&] { return testOptimalCache<keys::HashKeys>(cache_size, requests); }, opt_hash_rate);
+    double opt_dense_ms = measure([&] { return testOptimalCache<keys::DenseKeys>(cache_size, requests); }, opt_dense_rate);
 
-        std::cout << "\nParameters:\n";
-        std::cout << std::left << std::setw(20) << "Mode:" << mode << std::endl;
-        std::cout << std::setw(20) << "Requests:" << num_requests << std::endl;
-        std::cout << std::setw(20) << "Pages:" << num_pages << std::endl;
+    if (lfu_hash_rate != lfu_dense_rate || opt_hash_rate != opt_dense_rate)
+    {
+        throw BenchmarkException("Dense key policy changed the hit rate");
+    }
+
+    std::cout << "\nKey policy benchmark" << std::endl;
+    std::cout << std::string(60, '=') << std::endl;
+    std::cout << std::left << std::setw(12) << "Policy"
+              << std::setw(16) << "Hash keys, ms"
+              << std::setw(16) << "Dense keys, ms"
+              << std::setw(16) << "Speedup" << std::endl;
+    std::cout << std::string(60, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(12) << "LFU" << std::setw(16) << lfu_hash_ms << std::setw(16) << lfu_dense_ms
+              << lfu_hash_ms / lfu_dense_ms << "x" << std::endl;
+    std::cout << std::setw(12) << "Optimal" << std::setw(16) << opt_hash_ms << std::setw(16) << opt_dense_ms
+              << opt_hash_ms / opt_dense_ms << "x" << std::endl;
+    std::cout << std::string(60, '-') << std::endl;
+}
+
+
+
+/**
+ * @brief Замеряет скорость поиска жертвы (argmax по моментам следующего обращения)
+ * @details Для размеров кэша от 16 до 64K сравнивает скалярное ядро с выбранным во время выполнения
+ * 
+ * @throws BenchmarkException если векторное ядро вернуло другой индекс
+ */
+void runVictimSearchBenchmark()
+{
+    using Clock = std::chrono::steady_clock;
 
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<size_t> dist(0, 1u << 30);
 
+    std::cout << "\nVictim search benchmark (" << simd::argmaxImplementationName() << ")" << std::endl;
+    std::cout << std::string(60, '=') << std::endl;
+    std::cout << std::left << std::setw(12) << "Cache size"
+              << std::setw(16) << "Scalar, ns"
+              << std::setw(16) << "Dispatched, ns"
+              << std::setw(16) << "Speedup" << std::endl;
+    std::cout << std::string(60, '-') << std::endl;
 
+    const simd::ArgMaxFunc dispatched = simd::selectArgMax();
 
-        if (mode != "benchmark")
+    for (size_t size = 16; size <= 65536; size *= 4)
+    {
+        std::vector<size_t> next_use(size);
+        for (size_t& value : next_use)
         {
-            std::cout << std::setw(20) << "Cache size:" << cache_size << std::endl;
+            value = dist(gen);
         }
-        else
+
+        const size_t repeats = std::max<size_t>(1, (1u << 24) / size);
+        size_t checksum_scalar = 0;
+        size_t checksum_vector = 0;
+
+        auto time_kernel = [&](simd::ArgMaxFunc func, size_t& checksum)
+        {
+            auto start = Clock::now();
+            for (size_t r = 0; r < repeats; r++)
+            {
+                size_t idx = func(next_use.data(), size);
+                checksum += idx;
+                next_use[r % size] ^= idx & 1;
+            }
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / repeats;
+        };
+
+        std::vector<size_t> original = next_use;
+        double scalar_ns = time_kernel(simd::argmaxScalar, checksum_scalar);
+        next_use = original;
+        double vector_ns = time_kernel(dispatched, checksum_vector);
+
+        if (checksum_scalar != checksum_vector)
         {
-            std::cout << std::setw(20) << "Benchmark range:" << min_cache_size << " to " << max_cache_size << std::endl;
-            std::cout << std::setw(20) << "Step:" << step << std::endl;
+            throw BenchmarkException("Vector argmax disagrees with scalar argmax");
         }
 
+        std::cout << std::setw(12) << size << std::fixed << std::setprecision(1)
+                  << std::setw(16) << scalar_ns << std::setw(16) << vector_ns
+                  << std::setprecision(2) << scalar_ns / vector_ns << "x" << std::endl;
+    }
 
+    std::cout << std::string(60, '-') << std::endl;
+}
 
 
-        std::cout << std::setw(20) << "Request type:" << request_type << std::endl;
-        
-        std::cout << "\nGenerating requests..." << std::endl;
-        std::vector<int> requests;
-        
 
-        if (request_type == "sequential")
-        {
-            requests = generateSequentialRequests(num_requests, num_pages);
-        }
-        else
+/**
+ * @brief Оценивает кривые промахов LFU, LRU и оптимального кэша по пространственной выборке
+ * @param params Параметры (диапазон размеров, доля выборки, число seed, проверка)
+ * @param requests Последовательность запросов
+ * 
+ * @details Каждая оценка - среднее по shards_seeds независимым выборкам с 95% интервалом.
+ * С --validate считаются точные значения через runBenchmark и testLRUCache
+ * 
+ * @throws BenchmarkException если выборка пуста
+ */
+void runShardsEstimate(const SimulationParameters& params, const std::vector<int>& requests)
+{
+    std::vector<std::vector<int>> samples;
+    std::vector<shards::SpatialSampler<int>> samplers;
+    std::vector<std::shared_ptr<const opt::NextUseIndex>> indexes;
+
+    for (int seed = 0; seed < params.shards_seeds; seed++)
+    {
+        samplers.emplace_back(params.sample_rate, static_cast<uint64_t>(seed));
+        samples.push_back(samplers.back().sample(requests));
+        if (samples.back().empty())
         {
-            requests = generateRandomRequests(num_requests, num_pages);
+            throw BenchmarkException("Sample is empty, increase --sample-rate");
         }
-        
-        std::cout << "Generated " << requests.size() << " requests" << std::endl;
-        
+        // индекс выборки общий для всех размеров кэша
+        indexes.push_back(opt::NextUseIndex::build(samples.back()));
+    }
+
+    std::vector<BenchmarkResult> exact;
+    if (params.validate)
+    {
+        exact = runBenchmark(params.min_cache_size, params.max_cache_size, params.step, requests);
+    }
+
+    const int width = params.validate ? 102 : 72;
+
+    std::cout << "\nSampled miss ratios, % (rate " << samplers.front().rate() << ", "
+              << params.shards_seeds << " seeds, 95% interval)" << std::endl;
+    std::cout << std::string(width, '=') << std::endl;
+    std::cout << std::left << std::setw(12) << "Cache size" << std::setw(12) << "Scaled"
+              << std::setw(16) << "LFU" << std::setw(16) << "LRU" << std::setw(16) << "Optimal";
+    if (params.validate)
+    {
+        std::cout << std::setw(10) << "LFU ex" << std::setw(10) << "LRU ex" << std::setw(10) << "Opt ex";
+    }
+    std::cout << std::endl;
+    std::cout << std::string(width, '-') << std::endl;
 
+    size_t checked = 0;
+    size_t within = 0;
+    size_t row = 0;
 
+    for (size_t cache_size = params.min_cache_size; cache_size <= static_cast<size_t>(params.max_cache_size);
+         cache_size += params.step, row++)
+    {
+        std::vector<double> lfu_miss, lru_miss, opt_miss;
+        size_t scaled = samplers.front().scaleCacheSize(cache_size);
 
-        if (mode == "benchmark")
+        for (size_t i = 0; i < samples.size(); i++)
         {
-            std::vector<BenchmarkResult> results = runBenchmark(min_cache_size, max_cache_size, step, requests);
-            printBenchmarkResults(results);
+            size_t sample_size = samplers[i].scaleCacheSize(cache_size);
+            lfu_miss.push_back(100.0 * (1.0 - testLFUCache(sample_size, samples[i])));
+            lru_miss.push_back(100.0 * (1.0 - testLRUCache(sample_size, samples[i])));
+            opt_miss.push_back(100.0 * (1.0 - testOptimalCache(sample_size, samples[i], nullptr, indexes[i])));
         }
 
-        else
+        shards::Estimate estimates[3] = {shards::summarize(lfu_miss), shards::summarize(lru_miss), shards::summarize(opt_miss)};
+
+        std::cout << std::setw(12) << cache_size << std::setw(12) << scaled << std::fixed << std::setprecision(2);
+        for (const shards::Estimate& estimate : estimates)
         {
+            std::ostringstream cell;
+            cell << std::fixed << std::setprecision(2) << estimate.mean << " +- " << estimate.error;
+            std::cout << std::setw(16) << cell.str();
+        }
 
-            if (mode == "lfu" || mode == "compare")
-            {
-                std::cout << "\nTesting LFU cache..." << std::endl;
-                double lfu_hit_rate = testLFUCache(cache_size, requests);
-                std::cout << "LFU cache hit rate: " << std::fixed << std::setprecision(2) 
-                     << (lfu_hit_rate * 100) << "%" << std::endl;
-            }
-            
-            if (mode == "optimal" || mode == "compare")
-            {
-                std::cout << "\nTesting optimal cache..." << std::endl;
-                double optimal_hit_rate = testOptimalCache(cache_size, requests);
-                std::cout << "Optimal cache hit rate: " << std::fixed << std::setprecision(2) 
-                     << (optimal_hit_rate * 100) << "%" << std::endl;
-            }
-            
-            if (mode == "compare")
+        if (params.validate && row < exact.size())
+        {
+            double exact_miss[3] = {100.0 - exact[row].lfu_hit_rate,
+                                    100.0 * (1.0 - testLRUCache(cache_size, requests)),
+                                    100.0 - exact[row].optimal_hit_rate};
+            for (int p = 0; p < 3; p++)
             {
-                double lfu_hit_rate = testLFUCache(cache_size, requests);
-                double optimal_hit_rate = testOptimalCache(cache_size, requests);
-                double difference = optimal_hit_rate - lfu_hit_rate;
-                
-                std::cout << "\nHit rates:\n";
-                std::cout << "LFU:     " << std::fixed << std::setprecision(2) << (lfu_hit_rate * 100) << "%" << std::endl;
-                std::cout << "Optimal: " << std::fixed << std::setprecision(2) << (optimal_hit_rate * 100) << "%" << std::endl;
+                std::cout << std::setw(10) << exact_miss[p];
+                checked++;
+                if (std::abs(exact_miss[p] - estimates[p].mean) <= estimates[p].error)
+                {
+                    within++;
+                }
             }
         }
+        std::cout << std::endl;
     }
 
+    std::cout << std::string(width, '-') << std::endl;
+    if (params.validate)
+    {
+        std::cout << "Exact value inside the interval: " << within << " of " << checked << std::endl;
+    }
+}
 
 
 
+/**
+ * @brief Сравнивает статическое деление бюджета между арендаторами с динамическим перераспределением
+ * @param params Параметры (общий бюджет = cache_size, число арендаторов, длина эпохи)
+ * 
+ * @details Арендатор i запрашивает страницы из [1, pages * (i + 1)] с весом (tenants - i),
+ * трассы арендаторов перемешиваются в одну
+ */
+void runTenantSimulation(const SimulationParameters& params)
+{
+    const size_t tenant_count = params.tenants;
+    const size_t total_capacity = params.cache_size;
 
+    std::mt19937 gen(std::random_device{}());
+    std::vector<double> weights;
+    std::vector<std::uniform_int_distribution<int>> page_dists;
+    for (size_t i = 0; i < tenant_count; i++)
+    {
+        weights.push_back(static_cast<double>(tenant_count - i));
+        page_dists.emplace_back(1, params.num_pages * static_cast<int>(i + 1));
+    }
+    std::discrete_distribution<size_t> tenant_dist(weights.begin(), weights.end());
 
-
-
-
-
-    catch (const std::invalid_argument& e)
+    std::vector<std::pair<size_t, int>> trace;
+    trace.reserve(params.num_requests);
+    for (int i = 0; i < params.num_requests; i++)
     {
-        std::cerr << "Invalid argument - " << e.what() << std::endl;
-        return -1;
+        size_t tenant = tenant_dist(gen);
+        trace.emplace_back(tenant, page_dists[tenant](gen));
     }
 
-    catch (const ConfigurationException& e)
+    std::vector<std::unique_ptr<lfu::LFUCache<int, int>>> static_caches;
+    std::vector<size_t> static_hits(tenant_count, 0);
+    for (size_t i = 0; i < tenant_count; i++)
     {
-        std::cerr << e.what() << std::endl;
-        return -1;
+        size_t capacity = total_capacity / tenant_count + (i < total_capacity % tenant_count ? 1 : 0);
+        static_caches.push_back(std::make_unique<lfu::LFUCache<int, int>>(capacity, slow_get_page_int));
+    }
+
+    part::PartitionOptions options;
+    options.epoch_length = params.epoch;
+    part::PartitionedCache<int, int> dynamic(total_capacity, tenant_count, slow_get_page_int, options);
+
+    for (const auto& [tenant, page] : trace)
+    {
+        try
+        {
+            static_caches[tenant]->get(page);
+            static_hits[tenant]++;
+        }
+        catch (const std::out_of_range&)
+        {
+            static_caches[tenant]->put(page);
+        }
+
+        dynamic.access(tenant, page);
+    }
+
+    size_t static_total = 0;
+    size_t dynamic_total = 0;
+
+    std::cout << "\nTenant simulation (total capacity " << total_capacity << ", "
+              << dynamic.rebalanceCount() << " rebalances)" << std::endl;
+    std::cout << std::string(75, '=') << std::endl;
+    std::cout << std::left << std::setw(8) << "Tenant" << std::setw(11) << "Requests" << std::setw(9) << "Pages"
+              << std::setw(12) << "Static cap" << std::setw(12) << "Static hit"
+              << std::setw(12) << "Final cap" << std::setw(12) << "Dynamic hit" << std::endl;
+    std::cout << std::string(75, '-') << std::endl;
+
+    for (size_t i = 0; i < tenant_count; i++)
+    {
+        size_t requests = dynamic.requestCount(i);
+        double denominator = requests == 0 ? 1.0 : static_cast<double>(requests);
+        static_total += static_hits[i];
+        dynamic_total += dynamic.hitCount(i);
+
+        std::cout << std::setw(8) << i << std::setw(11) << requests << std::setw(9) << params.num_pages * (i + 1)
+                  << std::setw(12) << static_caches[i]->capacity()
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(12) << 100.0 * static_hits[i] / denominator
+                  << std::setw(12) << dynamic.capacityOf(i)
+                  << std::setw(12) << 100.0 * dynamic.hitCount(i) / denominator << std::endl;
+    }
+
+    double static_rate = 100.0 * static_total / trace.size();
+    double dynamic_rate = 100.0 * dynamic_total / trace.size();
+
+    std::cout << std::string(75, '-') << std::endl;
+    std::cout << "Static split hit rate:  " << static_rate << "%" << std::endl;
+    std::cout << "Dynamic hit rate:       " << dynamic_rate << "%" << std::endl;
+    std::cout << "Gain:                   " << dynamic_rate - static_rate << " pp" << std::endl;
+}
+
+
+
+/**
+ * @brief Сравнивает LFU кэш в памяти с двухуровневым кэшем (память + файл)
+ * @param params Параметры (размеры уровней, путь к журналу, стоимость доступа к уровням)
+ * @param requests Последовательность запросов
+ * 
+ * @throws StorageException если ошибка файлового уровня
+ */
+void runTieredSimulation(const SimulationParameters& params, const std::vector<int>& requests)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const size_t disk_size = params.disk_size > 0 ? params.disk_size : 10 * static_cast<size_t>(params.cache_size);
+
+    double lfu_hit_rate = testLFUCache(params.cache_size, requests);
+
+    tier::TieredCache<int, int> cache(params.cache_size, disk_size, params.tier_file, slow_get_page_int);
+
+    auto start = Clock::now();
+    for (int page : requests)
+    {
+        cache.get(page);
+    }
+    double elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    const double total = static_cast<double>(requests.size());
+    double memory_rate = cache.memoryHits() / total;
+    double disk_rate = cache.diskHits() / total;
+    double backend_rate = cache.backendLoads() / total;
+
+    double lfu_cost = lfu_hit_rate * params.memory_cost + (1.0 - lfu_hit_rate) * params.backend_cost;
+    double tiered_cost = memory_rate * params.memory_cost + disk_rate * params.disk_cost + backend_rate * params.backend_cost;
+
+    std::cout << "\nTiered cache (memory " << params.cache_size << ", disk " << disk_size << ")" << std::endl;
+    std::cout << std::string(45, '=') << std::endl;
+    std::cout << std::left << std::fixed << std::setprecision(2);
+    std::cout << std::setw(28) << "Memory hit rate:" << memory_rate * 100 << "%" << std::endl;
+    std::cout << std::setw(28) << "Disk hit rate:" << disk_rate * 100 << "%" << std::endl;
+    std::cout << std::setw(28) << "Backend loads:" << backend_rate * 100 << "%" << std::endl;
+    std::cout << std::setw(28) << "Demotions:" << cache.demotions() << std::endl;
+    std::cout << std::setw(28) << "Disk drops / compactions:" << cache.disk().droppedCount() << " / "
+              << cache.disk().compactionCount() << std::endl;
+    std::cout << std::setw(28) << "Wall time:" << elapsed_ms << " ms" << std::endl;
+    std::cout << std::string(45, '-') << std::endl;
+    std::cout << std::setw(28) << "LFU only hit rate:" << lfu_hit_rate * 100 << "%" << std::endl;
+    std::cout << std::setw(28) << "LFU only avg cost:" << lfu_cost << std::endl;
+    std::cout << std::setw(28) << "Tiered avg cost:" << tiered_cost << std::endl;
+}
+
+
+
+/**
+ * @brief Сравнивает способы хранения строковых ключей (URL) в LFU кэше
+ * @details Запросы приходят как std::string_view на общий буфер. Варианты: временная std::string на каждый
+ * поиск, прозрачный поиск по std::string_view (keys::StringKeys) и ключи в арене (InternedLFUCache)
+ * @param cache_size Размер кэша
+ * @param requests Последовательность запросов (номера страниц превращаются в URL)
+ * 
+ * @throws BenchmarkException если варианты разошлись по числу попаданий
+ */
+void runStringKeyBenchmark(size_t cache_size, const std::vector<int>& requests)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::map<int, std::string> urls;
+    for (int page : requests)
+    {
+        if (urls.find(page) == urls.end())
+        {
+            urls.emplace(page, "https://cdn.example.com/assets/v2/page-" + std::to_string(page) + "/index.html");
+        }
+    }
+
+    std::vector<std::string_view> keys;
+    keys.reserve(requests.size());
+    for (int page : requests)
+    {
+        keys.emplace_back(urls[page]);
+    }
+
+    auto load = [](std::string_view key) { return static_cast<int>(key.size()); };
+
+    struct Result
+    {
+        const char* name;
+        double ns_per_request;
+        size_t hits;
+    };
+
+    auto measure = [&](const char* name, auto&& cache, auto&& lookup, auto&& insert)
+    {
+        size_t hits = 0;
+        auto start = Clock::now();
+        for (std::string_view key : keys)
+        {
+            if (lookup(cache, key))
+            {
+                hits++;
+            }
+            else
+            {
+                insert(cache, key);
+            }
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        return Result{name, ns / keys.size(), hits};
+    };
+
+    std::vector<Result> results;
+
+    {
+        lfu::LFUCache<std::string, int> cache(cache_size, load);
+        results.push_back(measure("std::string", cache,
+            [](auto& c, std::string_view key)
+            {
+                std::string copy(key);
+                if (!c.contains(copy))
+                {
+                    return false;
+                }
+                c.get(copy);
+                return true;
+            },
+            [](auto& c, std::string_view key) { c.put(std::string(key)); }));
+    }
+
+    {
+        lfu::LFUCache<std::string, int, keys::StringKeys> cache(cache_size, load);
+        results.push_back(measure("string_view", cache,
+            [](auto& c, std::string_view key)
+            {
+                if (!c.contains(key))
+                {
+                    return false;
+                }
+                c.get(key);
+                return true;
+            },
+            [](auto& c, std::string_view key) { c.put(std::string(key)); }));
+    }
+
+    lfu::InternedLFUCache<int> interned(cache_size, load);
+    results.push_back(measure("interned", interned,
+        [](auto& c, std::string_view key)
+        {
+            if (!c.contains(key))
+            {
+                return false;
+            }
+            c.get(key);
+            return true;
+        },
+        [](auto& c, std::string_view key) { c.put(key); }));
+
+    for (const auto& result : results)
+    {
+        if (result.hits != results.front().hits)
+        {
+            throw BenchmarkException("String key variants changed the hit rate");
+        }
+    }
+
+    // у всех вариантов одинаковое содержимое, поэтому ключи в кэше берутся из последнего
+    size_t string_bytes = 0;
+    for (const auto& [page, url] : urls)
+    {
+        if (interned.contains(url))
+        {
+            // ключ лежит и в узле, и в таблице ключей; короткие строки помещаются в сам объект
+            size_t heap = url.size() > 15 ? url.size() + 1 : 0;
+            string_bytes += 2 * (sizeof(std::string) + heap);
+        }
+    }
+    size_t interned_bytes = 2 * sizeof(std::string_view) * interned.size() + interned.arena().reservedBytes();
+
+    std::cout << "\nString key benchmark (" << urls.size() << " distinct URLs, capacity " << cache_size << ")" << std::endl;
+    std::cout << std::string(60, '=') << std::endl;
+    std::cout << std::left << std::setw(16) << "Keys"
+              << std::setw(16) << "ns/request"
+              << std::setw(14) << "Hit rate, %"
+              << std::setw(14) << "Key bytes" << std::endl;
+    std::cout << std::string(60, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& result : results)
+    {
+        bool is_interned = &result == &results.back();
+        std::cout << std::setw(16) << result.name
+                  << std::setw(16) << result.ns_per_request
+                  << std::setw(14) << 100.0 * result.hits / keys.size()
+                  << (is_interned ? interned_bytes : string_bytes) << std::endl;
+    }
+    std::cout << std::string(60, '-') << std::endl;
+}
+
+
+
+/**
+ * @brief Сравнивает память и скорость LFUCache и CompactLFUCache
+ * @details Память - прирост занятой кучи (mallinfo2) после заполнения кэша cache_size различными ключами,
+ * то есть вместе с накладными расходами аллокатора. Скорость - прогон запросов через contains/get/put
+ * @param cache_size Размер кэша
+ * @param requests Последовательность запросов
+ */
+void runCompactBenchmark(size_t cache_size, const std::vector<int>& requests)
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto heap_in_use = []() { return static_cast<double>(mallinfo2().uordblks); };
+
+    struct Result
+    {
+        const char* name;
+        double bytes_per_entry;
+        double ns_per_request;
+        size_t hits;
+    };
+
+    auto measure = [&](const char* name, auto make)
+    {
+        Result result{name, 0.0, 0.0, 0};
+
+        double before = heap_in_use();
+        {
+            auto cache = make();
+            for (size_t i = 0; i < cache_size; i++)
+            {
+                cache->put(-static_cast<int>(i) - 1);
+            }
+            result.bytes_per_entry = (heap_in_use() - before) / static_cast<double>(cache_size);
+        }
+
+        auto cache = make();
+        auto start = Clock::now();
+        for (int page : requests)
+        {
+            if (cache->contains(page))
+            {
+                cache->get(page);
+                result.hits++;
+            }
+            else
+            {
+                cache->put(page);
+            }
+        }
+        result.ns_per_request = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / requests.size();
+        return result;
+    };
+
+    std::vector<Result> results;
+    results.push_back(measure("LFUCache", [&] { return std::make_unique<lfu::LFUCache<int, int>>(cache_size, slow_get_page_int); }));
+    results.push_back(measure("Compact", [&] { return std::make_unique<lfu::CompactLFUCache<int, int>>(cache_size, slow_get_page_int); }));
+
+    // при частотах выше 255 порядок вытеснения может разойтись, поэтому расхождение только сообщается
+    bool same_hits = results[0].hits == results[1].hits;
+
+    std::cout << "\nCompact layout benchmark (capacity " << cache_size << ", <int, int> entries)" << std::endl;
+    std::cout << std::string(60, '=') << std::endl;
+    std::cout << std::left << std::setw(14) << "Layout"
+              << std::setw(16) << "Bytes/entry"
+              << std::setw(16) << "ns/request"
+              << std::setw(14) << "Hit rate, %" << std::endl;
+    std::cout << std::string(60, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& result : results)
+    {
+        std::cout << std::setw(14) << result.name
+                  << std::setw(16) << result.bytes_per_entry
+                  << std::setw(16) << result.ns_per_request
+                  << 100.0 * result.hits / requests.size() << std::endl;
+    }
+    std::cout << std::string(60, '-') << std::endl;
+    if (!same_hits)
+    {
+        std::cout << "Hit counts differ: some keys reached the saturated frequency" << std::endl;
+    }
+}
+
+
+
+/**
+ * @brief Индекс следующего обращения для трассы, общий для всех оптимальных кэшей
+ * @details С --index-cache и --trace-file индекс отображается из файла <trace>.nextuse, если тот построен
+ * по этой же трассе, иначе строится и сохраняется туда для следующих запусков
+ * @param params Параметры (файл трассы и флаг сохранения индекса)
+ * @param requests Последовательность запросов
+ */
+std::shared_ptr<const opt::NextUseIndex> prepareNextUseIndex(const SimulationParameters& params, const std::vector<int>& requests)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const bool cached = params.index_cache && !params.trace_file.empty();
+    const std::string path = params.trace_file + ".nextuse";
+
+    auto start = Clock::now();
+    if (cached && std::filesystem::exists(path))
+    {
+        try
+        {
+            auto index = opt::NextUseIndex::load(path, opt::NextUseIndex::traceHash(requests));
+            std::cout << "Loaded next-use index from " << path << " in " << std::fixed << std::setprecision(2)
+                      << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << " ms" << std::endl;
+            return index;
+        }
+        catch (const StorageException& e)
+        {
+            std::cerr << e.what() << ", rebuilding" << std::endl;
+            start = Clock::now();
+        }
+    }
+
+    auto index = opt::NextUseIndex::build(requests);
+    std::cout << "Built next-use index in " << std::fixed << std::setprecision(2)
+              << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << " ms" << std::endl;
+
+    if (cached)
+    {
+        try
+        {
+            index->save(path);
+            std::cout << "Saved next-use index to " << path << std::endl;
+        }
+        catch (const StorageException& e)
+        {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+    return index;
+}
+
+
+
+/**
+ * @brief Замеряет задержку запросов LFU кэша, вместимость которого уменьшают посреди нагрузки
+ * @details Первая половина запросов прогревает кэш, затем onMemoryPressure уменьшает вместимость,
+ * и задержка каждого следующего запроса (вместе с самим уменьшением) сравнивается для вытеснения
+ * всех лишних элементов сразу и порциями
+ * @param params Параметры (размер кэша и уровень давления)
+ * @param requests Последовательность запросов
+ */
+void runResizeBenchmark(const SimulationParameters& params, const std::vector<int>& requests)
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Result
+    {
+        double pause_us;
+        double p50_ns;
+        double p99_ns;
+        double max_ns;
+        double hit_rate;
+    };
+
+    auto run = [&](size_t chunk)
+    {
+        lfu::LFUCache<int, int> cache(params.cache_size, slow_get_page_int);
+        cache.setResizeChunk(chunk);
+
+        auto access = [&](int page)
+        {
+            try
+            {
+                cache.get(page);
+                return true;
+            }
+            catch (const std::out_of_range&)
+            {
+                cache.put(page);
+                return false;
+            }
+        };
+
+        const size_t warmup = requests.size() / 2;
+        for (size_t i = 0; i < warmup; i++)
+        {
+            access(requests[i]);
+        }
+
+        auto pause_start = Clock::now();
+        cache.onMemoryPressure(params.pressure);
+        auto pause_end = Clock::now();
+
+        std::vector<double> latencies;
+        latencies.reserve(requests.size() - warmup);
+        size_t hits = 0;
+        for (size_t i = warmup; i < requests.size(); i++)
+        {
+            auto start = Clock::now();
+            hits += access(requests[i]);
+            latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        }
+
+        // паузу уменьшения несет запрос, во время которого пришло уведомление
+        if (!latencies.empty())
+        {
+            latencies[0] += std::chrono::duration<double, std::nano>(pause_end - pause_start).count();
+        }
+
+        auto percentile = [&](double q)
+        {
+            size_t index = std::min(latencies.size() - 1, static_cast<size_t>(q * latencies.size()));
+            std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+            return latencies[index];
+        };
+
+        Result result;
+        result.pause_us = std::chrono::duration<double, std::micro>(pause_end - pause_start).count();
+        result.hit_rate = latencies.empty() ? 0.0 : static_cast<double>(hits) / latencies.size();
+        result.max_ns = latencies.empty() ? 0.0 : *std::max_element(latencies.begin(), latencies.end());
+        result.p99_ns = latencies.empty() ? 0.0 : percentile(0.99);
+        result.p50_ns = latencies.empty() ? 0.0 : percentile(0.5);
+        return result;
+    };
+
+    Result eager = run(SIZE_MAX);
+    Result chunked = run(lfu::LFUCache<int, int>::kDefaultResizeChunk);
+
+    std::cout << "\nResize under load (capacity " << params.cache_size << ", pressure " << params.pressure << ")" << std::endl;
+    std::cout << std::string(75, '=') << std::endl;
+    std::cout << std::left << std::setw(12) << "Shrink"
+              << std::setw(14) << "Pause, us"
+              << std::setw(12) << "p50, ns"
+              << std::setw(12) << "p99, ns"
+              << std::setw(14) << "Max, ns"
+              << std::setw(12) << "Hit rate" << std::endl;
+    std::cout << std::string(75, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& [name, result] : {std::pair<const char*, Result>{"eager", eager}, {"chunked", chunked}})
+    {
+        std::cout << std::setw(12) << name
+                  << std::setw(14) << result.pause_us
+                  << std::setw(12) << result.p50_ns
+                  << std::setw(12) << result.p99_ns
+                  << std::setw(14) << result.max_ns
+                  << result.hit_rate * 100 << "%" << std::endl;
+    }
+    std::cout << std::string(75, '-') << std::endl;
+}
+
+
+
+/**
+ * @brief Сравнивает политики по суммарной стоимости промахов при разной стоимости загрузки ключей
+ * @details Стоимость ключа распределена лог-равномерно в [1, cost_spread] и фиксирована хешем ключа.
+ * Функция загрузки сдвигает виртуальные часы на стоимость ключа, а кэши измеряют ее по этим часам
+ * так же, как измеряли бы реальное время работы загрузчика
+ * @param params Параметры (размер кэша и разброс стоимости)
+ * @param requests Последовательность запросов
+ */
+void runCostSimulation(const SimulationParameters& params, const std::vector<int>& requests)
+{
+    const double log_spread = std::log(params.cost_spread);
+    auto cost_of = [log_spread](int page)
+    {
+        uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(page)) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 29;
+        double unit = static_cast<double>(h >> 11) / static_cast<double>(1ULL << 53);
+        return static_cast<uint64_t>(std::llround(std::exp(unit * log_spread)));
+    };
+
+    uint64_t virtual_now = 0;
+    auto clock = [&virtual_now]() { return virtual_now; };
+    auto load = [&](int page)
+    {
+        virtual_now += cost_of(page);
+        return slow_get_page_int(page);
+    };
+
+    uint64_t total_cost = 0;
+    for (int page : requests)
+    {
+        total_cost += cost_of(page);
+    }
+
+    struct Result
+    {
+        const char* name;
+        double hit_rate;
+        uint64_t miss_cost;
+    };
+    std::vector<Result> results;
+
+    {
+        uint64_t lfu_cost = 0;
+        lfu::LFUCache<int, int> cache(params.cache_size, [&](int page)
+        {
+            lfu_cost += cost_of(page);
+            return slow_get_page_int(page);
+        });
+        size_t hits = 0;
+        for (int page : requests)
+        {
+            try
+            {
+                cache.get(page);
+                hits++;
+            }
+            catch (const std::out_of_range&)
+            {
+                cache.put(page);
+            }
+        }
+        results.push_back({"LFU", static_cast<double>(hits) / requests.size(), lfu_cost});
+    }
+
+    {
+        lfu::GDSFCache<int, int> cache(params.cache_size, load);
+        cache.setClock(clock);
+        size_t hits = 0;
+        for (int page : requests)
+        {
+            try
+            {
+                cache.get(page);
+                hits++;
+            }
+            catch (const std::out_of_range&)
+            {
+                cache.put(page);
+            }
+        }
+        results.push_back({"GDSF", static_cast<double>(hits) / requests.size(), cache.missCost()});
+    }
+
+    for (bool cost_aware : {false, true})
+    {
+        opt::OptimalCache<int, int> cache(params.cache_size, load);
+        cache.setClock(clock);
+        cache.setCostAware(cost_aware);
+        cache.preprocessRequests(requests);
+        for (int page : requests)
+        {
+            cache.step(page);
+        }
+        results.push_back({cost_aware ? "OPT-cost" : "OPT", cache.getHitRate(), cache.getMissCost()});
+    }
+
+    const double lfu_cost = static_cast<double>(results.front().miss_cost);
+
+    std::cout << "\nCost-aware caching (capacity " << params.cache_size << ", cost spread " << params.cost_spread
+              << ", cost of all requests " << total_cost << ")" << std::endl;
+    std::cout << std::string(75, '=') << std::endl;
+    std::cout << std::left << std::setw(12) << "Policy"
+              << std::setw(14) << "Hit rate, %"
+              << std::setw(16) << "Miss cost"
+              << std::setw(16) << "Cost saved, %"
+              << std::setw(16) << "vs LFU, %" << std::endl;
+    std::cout << std::string(75, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& result : results)
+    {
+        double saved = 100.0 * static_cast<double>(total_cost - result.miss_cost) / static_cast<double>(total_cost);
+        double versus_lfu = lfu_cost == 0.0 ? 0.0 : 100.0 * (lfu_cost - static_cast<double>(result.miss_cost)) / lfu_cost;
+        std::cout << std::setw(12) << result.name
+                  << std::setw(14) << result.hit_rate * 100
+                  << std::setw(16) << result.miss_cost
+                  << std::setw(16) << saved
+                  << versus_lfu << std::endl;
+    }
+    std::cout << std::string(75, '-') << std::endl;
+    std::cout << "Cost saved - share of the cost of all requests avoided by hits" << std::endl;
+}
+
+
+
+void printHelp()
+{
+    std::cout << "\nCompare lfu and optimal caches\n\n";
+
+    std::cout << "Usage:\n";
+    std::cout << "  --mode=lfu              : Run only LFU cache simulation\n";
+    std::cout << "  --mode=optimal          : Run only Optimal cache simulation\n";
+    std::cout << "  --mode=compare          : Compare both (default)\n";
+    std::cout << "  --mode=benchmark        : Run benchmark\n";
+    std::cout << "  --mode=snapshot         : Measure LFU snapshot/restore time for --cache-size entries\n";
+    std::cout << "  --mode=dense            : Compare hashed and direct-indexed page keys\n";
+    std::cout << "  --mode=strings          : Compare string, string_view and interned URL keys\n";
+    std::cout << "  --mode=compact          : Bytes per entry and throughput of the compact LFU layout\n";
+    std::cout << "  --mode=victim           : Measure optimal cache victim search kernels\n";
+    std::cout << "  --mode=shards           : Estimate LFU/LRU/optimal miss ratio curves on a sampled trace\n";
+    std::cout << "  --mode=tenants          : Replay interleaved tenant traces, static vs dynamic budget split\n";
+    std::cout << "  --mode=tiered           : LFU in memory over a file-backed second tier\n";
+    std::cout << "  --mode=resize           : Request latency while LFU capacity shrinks under memory pressure\n";
+    std::cout << "  --mode=cost             : Miss cost of LFU, GDSF and optimal caches with per-key load costs\n\n";
+    
+    std::cout << "Simulation Parameters:\n";
+    std::cout << "  --requests=<number>     : Number of requests to generate (default: 1000)\n";
+    std::cout << "  --pages=<number>        : Number of unique pages (default: 100)\n";
+    std::cout << "  --cache-size=<number>   : Cache size for simulation (default: 10)\n";
+    std::cout << "  --request-type=<type>   : Type of requests (random/sequential, default: random)\n";
+    std::cout << "  --trace-file=<path>     : Replay requests from a trace file instead of generating them\n";
+    std::cout << "  --save-trace=<path>     : Save the requests to a binary trace (see trace_stats)\n";
+    std::cout << "  --index-cache           : Reuse the optimal cache next-use index from <trace-file>.nextuse\n\n";
+
+    std::cout << "Timeline Parameters (lfu, optimal and compare modes):\n";
+    std::cout << "  --timeline=<path>       : Write per-window statistics (CSV if the path ends in .csv, else binary)\n";
+    std::cout << "  --window=<number>       : Requests per window (default: 1000)\n\n";
+    
+    std::cout << "Benchmark Parameters:\n";
+    std::cout << "  --min-size=<number>     : Minimum cache size (default: 5)\n";
+    std::cout << "  --max-size=<number>     : Maximum cache size (default: 50)\n";
+    std::cout << "  --step=<number>         : Step for cache size (default: 5)\n\n";
+
+    std::cout << "Sampling Parameters (shards mode, uses benchmark size range):\n";
+    std::cout << "  --sample-rate=<number>  : Fraction of keys kept in the sample (default: 0.1)\n";
+    std::cout << "  --shards-seeds=<number> : Independent samples for error bounds (default: 5)\n";
+    std::cout << "  --validate              : Also compute exact miss ratios\n\n";
+
+    std::cout << "Tenant Parameters (tenants mode, --cache-size is the shared budget):\n";
+    std::cout << "  --tenants=<number>      : Number of tenants (default: 4)\n";
+    std::cout << "  --epoch=<number>        : Requests between rebalances (default: 1000)\n\n";
+
+    std::cout << "Tier Parameters (tiered mode, --cache-size is the memory tier):\n";
+    std::cout << "  --disk-size=<number>    : Disk tier entries (default: 10 x cache size)\n";
+    std::cout << "  --tier-file=<path>      : Disk tier log (default: lfu.tier)\n";
+    std::cout << "  --memory-cost=<number>  : Cost of a memory hit (default: 1)\n";
+    std::cout << "  --disk-cost=<number>    : Cost of a disk hit (default: 100)\n";
+    std::cout << "  --backend-cost=<number> : Cost of a backend load (default: 10000)\n\n";
+
+    std::cout << "Resize Parameters:\n";
+    std::cout << "  --pressure=<number>     : Fraction of the capacity to release, 0..1 (default: 0.75)\n\n";
+
+    std::cout << "Cost Parameters:\n";
+    std::cout << "  --cost-spread=<number>  : Ratio of the most to the least expensive load, >= 1 (default: 100)\n\n";
+
+    std::cout << "Snapshot Parameters:\n";
+    std::cout << "  --snapshot-file=<path>  : Snapshot file (default: lfu.snapshot)\n\n";
+}
+
+
+int getParameters(int argc, char** argv, SimulationParameters& params)
+{
+    params = SimulationParameters();
+    
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        
+        if (arg == "--help" || arg == "-h")
+        {
+            printHelp();
+            params.help = true;
+            return 0;
+        }
+        else if (arg.substr(0, 7) == "--mode=")
+        {
+            params.mode = arg.substr(7);
+        }
+        else if (arg.substr(0, 11) == "--requests=")
+        {
+            params.num_requests = stoi(arg.substr(11));
+        }
+        else if (arg.substr(0, 8) == "--pages=")
+        {
+            params.num_pages = stoi(arg.substr(8));
+        }
+        else if (arg.substr(0, 13) == "--cache-size=")
+        {
+            params.cache_size = stoul(arg.substr(13));
+        }
+        else if (arg.substr(0, 15) == "--request-type=")
+        {
+            params.request_type = arg.substr(15);
+        }
+        else if (arg.substr(0, 11) == "--min-size=")
+        {
+            params.min_cache_size = stoul(arg.substr(11));
+        }
+        else if (arg.substr(0, 11) == "--max-size=")
+        {
+            params.max_cache_size = stoul(arg.substr(11));
+        }
+        else if (arg.substr(0, 7) == "--step=")
+        {
+            params.step = stoul(arg.substr(7));
+        }
+        else if (arg.substr(0, 16) == "--snapshot-file=")
+        {
+            params.snapshot_file = arg.substr(16);
+        }
+        else if (arg.substr(0, 14) == "--sample-rate=")
+        {
+            params.sample_rate = stod(arg.substr(14));
+        }
+        else if (arg.substr(0, 15) == "--shards-seeds=")
+        {
+            params.shards_seeds = stoi(arg.substr(15));
+        }
+        else if (arg == "--validate")
+        {
+            params.validate = true;
+        }
+        else if (arg.substr(0, 10) == "--tenants=")
+        {
+            params.tenants = stoi(arg.substr(10));
+        }
+        else if (arg.substr(0, 8) == "--epoch=")
+        {
+            params.epoch = stoi(arg.substr(8));
+        }
+        else if (arg.substr(0, 12) == "--disk-size=")
+        {
+            params.disk_size = stoi(arg.substr(12));
+        }
+        else if (arg.substr(0, 12) == "--tier-file=")
+        {
+            params.tier_file = arg.substr(12);
+        }
+        else if (arg.substr(0, 14) == "--memory-cost=")
+        {
+            params.memory_cost = stod(arg.substr(14));
+        }
+        else if (arg.substr(0, 12) == "--disk-cost=")
+        {
+            params.disk_cost = stod(arg.substr(12));
+        }
+        else if (arg.substr(0, 15) == "--backend-cost=")
+        {
+            params.backend_cost = stod(arg.substr(15));
+        }
+        else if (arg.substr(0, 13) == "--trace-file=")
+        {
+            params.trace_file = arg.substr(13);
+        }
+        else if (arg.substr(0, 13) == "--save-trace=")
+        {
+            params.save_trace = arg.substr(13);
+        }
+        else if (arg == "--index-cache")
+        {
+            params.index_cache = true;
+        }
+        else if (arg.substr(0, 11) == "--pressure=")
+        {
+            params.pressure = stod(arg.substr(11));
+        }
+        else if (arg.substr(0, 11) == "--timeline=")
+        {
+            params.timeline_file = arg.substr(11);
+        }
+        else if (arg.substr(0, 9) == "--window=")
+        {
+            params.window = stoi(arg.substr(9));
+        }
+        else if (arg.substr(0, 14) == "--cost-spread=")
+        {
+            params.cost_spread = stod(arg.substr(14));
+        }
+        else
+        {
+            throw ConfigurationException("Unknown argument: " + arg);
+        }
+    }
+    
+    if (params.num_requests <= 0)
+    {
+        throw std::invalid_argument("Number of requests must be > 0: " + std::to_string(params.num_requests));
+    }
+
+    if (params.num_pages <= 0)
+    {
+        throw std::invalid_argument("Number of pages must be > 0: " + std::to_string(params.num_pages));
+    }
+
+    const std::vector<std::string> modes = {"lfu", "optimal", "compare", "benchmark", "snapshot", "dense", "strings", "compact", "victim", "shards", "tenants", "tiered", "resize", "cost"};
+    if (std::find(modes.begin(), modes.end(), params.mode) == modes.end())
+    {
+        throw ConfigurationException("Invalid mode: " + params.mode);
+    }
+
+    if (params.request_type != "random" && params.request_type != "sequential")
+    {
+        throw ConfigurationException("Invalid request type");
+    }
+
+    if (params.index_cache && params.trace_file.empty())
+    {
+        throw ConfigurationException("--index-cache requires --trace-file");
+    }
+
+    if (params.mode == "shards" && params.shards_seeds <= 0)
+    {
+        throw std::invalid_argument("Number of sampling seeds must be > 0");
+    }
+
+    if (params.mode == "tenants")
+    {
+        if (params.tenants <= 0 || params.tenants > params.cache_size)
+        {
+            throw std::invalid_argument("Number of tenants must be in [1, cache size]");
+        }
+        if (params.epoch <= 0)
+        {
+            throw std::invalid_argument("Epoch must be > 0");
+        }
+    }
+
+    if (params.mode == "resize" && !(params.pressure >= 0.0 && params.pressure <= 1.0))
+    {
+        throw std::invalid_argument("Memory pressure must be in [0, 1]");
+    }
+
+    if (!params.timeline_file.empty() && params.window <= 0)
+    {
+        throw std::invalid_argument("Timeline window must be > 0");
+    }
+
+    if (params.mode == "cost" && !(params.cost_spread >= 1.0))
+    {
+        throw std::invalid_argument("Cost spread must be >= 1");
+    }
+
+    const bool uses_size_range = params.mode == "benchmark" || params.mode == "shards";
+
+    if (!uses_size_range && params.cache_size <= 0)
+    {
+        throw std::invalid_argument("Cache size must be > 0");
+    }
+
+    if (uses_size_range)
+    {
+        if (params.min_cache_size <= 0)
+        {
+            throw std::invalid_argument("Minimum cache size must be greater than 0");
+        }
+        if (params.max_cache_size < params.min_cache_size)
+        {
+            throw std::invalid_argument("Maximum cache size must be >= minimum cache size");
+        }
+        if (params.step <= 0)
+        {
+            throw std::invalid_argument("Step must be greater than 0");
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    SimulationParameters params;
+    
+    try
+    {
+        getParameters(argc, argv, params);
+
+        if (params.help)
+        {
+            return 0;
+        }
+
+        if (params.mode == "snapshot")
+        {
+            runSnapshotBenchmark(params.cache_size, params.snapshot_file);
+            return 0;
+        }
+
+        if (params.mode == "victim")
+        {
+            runVictimSearchBenchmark();
+            return 0;
+        }
+
+        if (params.mode == "tenants")
+        {
+            runTenantSimulation(params);
+            return 0;
+        }
+
+
+
+        std::cout << "\nParameters:\n";
+        std::cout << std::left << std::setw(20) << "Mode:" << params.mode << std::endl;
+        std::cout << std::setw(20) << "Requests:" << params.num_requests << std::endl;
+        std::cout << std::setw(20) << "Pages:" << params.num_pages << std::endl;
+
+
+
+
+        if (params.mode != "benchmark" && params.mode != "shards")
+        {
+            std::cout << std::setw(20) << "Cache size:" << params.cache_size << std::endl;
+        }
+        else
+        {
+            std::cout << std::setw(20) << "Benchmark range:" << params.min_cache_size << " to " << params.max_cache_size << std::endl;
+            std::cout << std::setw(20) << "Step:" << params.step << std::endl;
+        }
+
+
+
+
+        std::vector<int> requests;
+
+        if (!params.trace_file.empty())
+        {
+            std::cout << std::setw(20) << "Trace file:" << params.trace_file << std::endl;
+            requests = trace::readTrace(params.trace_file);
+            if (requests.empty())
+            {
+                throw ConfigurationException("Trace is empty: " + params.trace_file);
+            }
+            std::cout << "\nRead " << requests.size() << " requests" << std::endl;
+        }
+        else
+        {
+            std::cout << std::setw(20) << "Request type:" << params.request_type << std::endl;
+        
+            std::cout << "\nGenerating requests..." << std::endl;
+
+            if (params.request_type == "sequential")
+            {
+                requests = generateSequentialRequests(params.num_requests, params.num_pages);
+            }
+            else
+            {
+                requests = generateRandomRequests(params.num_requests, params.num_pages);
+            }
+        
+            std::cout << "Generated " << requests.size() << " requests" << std::endl;
+        }
+
+        if (!params.save_trace.empty())
+        {
+            trace::writeTrace(params.save_trace, requests);
+            std::cout << "Saved trace to " << params.save_trace << std::endl;
+        }
+        
+
+
+
+        if (params.mode == "benchmark")
+        {
+            auto index = prepareNextUseIndex(params, requests);
+            std::vector<BenchmarkResult> results = runBenchmark(params.min_cache_size, params.max_cache_size, params.step,
+                                                                requests, index);
+            printBenchmarkResults(results);
+        }
+        else if (params.mode == "tiered")
+        {
+            runTieredSimulation(params, requests);
+        }
+        else if (params.mode == "resize")
+        {
+            runResizeBenchmark(params, requests);
+        }
+        else if (params.mode == "cost")
+        {
+            runCostSimulation(params, requests);
+        }
+        else if (params.mode == "shards")
+        {
+            runShardsEstimate(params, requests);
+        }
+        else if (params.mode == "dense")
+        {
+            runDenseKeyBenchmark(params.cache_size, requests);
+        }
+        else if (params.mode == "strings")
+        {
+            runStringKeyBenchmark(params.cache_size, requests);
+        }
+        else if (params.mode == "compact")
+        {
+            runCompactBenchmark(params.cache_size, requests);
+        }
+
+        else
+        {
+
+            const bool record = !params.timeline_file.empty();
+            std::vector<timeline::Timeline> timelines;
+
+            std::shared_ptr<const opt::NextUseIndex> index;
+            if (params.mode == "optimal" || params.mode == "compare")
+            {
+                index = prepareNextUseIndex(params, requests);
+            }
+
+            if (params.mode == "lfu" || params.mode == "compare")
+            {
+                std::cout << "\nTesting LFU cache..." << std::endl;
+                timeline::Recorder recorder("LFU", params.window);
+                double lfu_hit_rate = testLFUCache(params.cache_size, requests, record ? &recorder : nullptr);
+                std::cout << "LFU cache hit rate: " << std::fixed << std::setprecision(2) 
+                     << (lfu_hit_rate * 100) << "%" << std::endl;
+
+                if (record)
+                {
+                    timeline::Recorder lru_recorder("LRU", params.window);
+                    testLRUCache(params.cache_size, requests, &lru_recorder);
+                    timelines.push_back(recorder.timeline());
+                    timelines.push_back(lru_recorder.timeline());
+                }
+            }
+            
+            if (params.mode == "optimal" || params.mode == "compare")
+            {
+                std::cout << "\nTesting optimal cache..." << std::endl;
+                timeline::Recorder recorder("Optimal", params.window);
+                double optimal_hit_rate = testOptimalCache(params.cache_size, requests, record ? &recorder : nullptr, index);
+                std::cout << "Optimal cache hit rate: " << std::fixed << std::setprecision(2) 
+                     << (optimal_hit_rate * 100) << "%" << std::endl;
+
+                if (record)
+                {
+                    timelines.push_back(recorder.timeline());
+                }
+            }
+
+            if (record)
+            {
+                timeline::write(params.timeline_file, timelines);
+                std::cout << "\nSaved " << timelines.front().rows() << " windows of " << params.window
+                          << " requests per policy to " << params.timeline_file << std::endl;
+            }
+            
+            if (params.mode == "compare")
+            {
+                double lfu_hit_rate = testLFUCache(params.cache_size, requests);
+                double optimal_hit_rate = testOptimalCache(params.cache_size, requests, nullptr, index);
+                double difference = optimal_hit_rate - lfu_hit_rate;
+                
+                std::cout << "\nHit rates:\n";
+                std::cout << "LFU:     " << std::fixed << std::setprecision(2) << (lfu_hit_rate * 100) << "%" << std::endl;
+                std::cout << "Optimal: " << std::fixed << std::setprecision(2) << (optimal_hit_rate * 100) << "%" << std::endl;
+            }
+        }
+    }
+
+
+
+
+
+
+
+
+
+
+    catch (const std::invalid_argument& e)
+    {
+        std::cerr << "Invalid argument - " << e.what() << std::endl;
+        return -1;
+    }
+
+    catch (const ConfigurationException& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
     }
     catch (const CacheOperationException& e)
     {
@@ -515,6 +1837,11 @@ int main(int argc, char* argv[])
         std::cerr << e.what() << std::endl;
         return -1;
     }
+    catch (const StorageException& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
 
     catch (const std::exception& e)
     {
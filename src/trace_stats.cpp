@@ -0,0 +1,294 @@
+/**
+ * @file trace_stats.cpp
+ * @brief Анализ трассы запросов перед выбором размера кэша и политики
+ * @details Трасса читается порциями. Число различных ключей (HyperLogLog) и самые частые ключи
+ * (Space-Saving) считаются параллельно по частям порции, расстояния повторного использования
+ * и рабочее множество - в отдельном потоке по пространственной выборке ключей
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+#include "TraceFile.h"
+#include "TraceStats.h"
+#include "exceptions/ConfigurationException.h"
+#include "exceptions/StorageException.h"
+
+/**
+ * @brief Параметры анализа
+ */
+struct StatsParameters
+{
+    std::string trace_file;
+    double sample_rate = 1.0;
+    size_t max_keys = 1 << 20;
+    std::vector<uint64_t> windows = {1000, 10000, 100000, 1000000};
+    unsigned threads = 0;
+    size_t top = 1024;
+    size_t chunk = 1 << 20;
+    bool help = false;
+};
+
+void printHelp()
+{
+    std::cout << "\nReport request trace statistics\n\n";
+
+    std::cout << "Usage:\n";
+    std::cout << "  trace_stats --trace-file=<path> [options]\n\n";
+
+    std::cout << "Options:\n";
+    std::cout << "  --trace-file=<path>     : Binary (written by main --save-trace) or text trace\n";
+    std::cout << "  --sample-rate=<number>  : Initial fraction of keys for reuse/working set analysis (default: 1)\n";
+    std::cout << "  --max-keys=<number>     : Sampled keys limit, the rate drops when exceeded (default: 1048576)\n";
+    std::cout << "  --windows=<a,b,...>     : Working set windows in requests (default: 1000,10000,100000,1000000)\n";
+    std::cout << "  --threads=<number>      : Counting threads (default: hardware concurrency)\n";
+    std::cout << "  --top=<number>          : Heavy hitter counters for the Zipf fit (default: 1024)\n";
+    std::cout << "  --chunk=<number>        : Requests per chunk (default: 1048576)\n\n";
+}
+
+/**
+ * @brief Разобрать список чисел через запятую
+ * @throws ConfigurationException если список пуст или содержит не число
+ */
+std::vector<uint64_t> parseList(const std::string& text)
+{
+    std::vector<uint64_t> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (item.empty() || item.find_first_not_of("0123456789") != std::string::npos)
+        {
+            throw ConfigurationException("Invalid number in list: " + text);
+        }
+        values.push_back(std::stoull(item));
+    }
+    if (values.empty())
+    {
+        throw ConfigurationException("Empty list: " + text);
+    }
+    return values;
+}
+
+int getParameters(int argc, char** argv, StatsParameters& params)
+{
+    params = StatsParameters();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h")
+        {
+            printHelp();
+            params.help = true;
+            return 0;
+        }
+        else if (arg.substr(0, 13) == "--trace-file=")
+        {
+            params.trace_file = arg.substr(13);
+        }
+        else if (arg.substr(0, 14) == "--sample-rate=")
+        {
+            params.sample_rate = std::stod(arg.substr(14));
+        }
+        else if (arg.substr(0, 11) == "--max-keys=")
+        {
+            params.max_keys = std::stoul(arg.substr(11));
+        }
+        else if (arg.substr(0, 10) == "--windows=")
+        {
+            params.windows = parseList(arg.substr(10));
+        }
+        else if (arg.substr(0, 10) == "--threads=")
+        {
+            params.threads = static_cast<unsigned>(std::stoul(arg.substr(10)));
+        }
+        else if (arg.substr(0, 6) == "--top=")
+        {
+            params.top = std::stoul(arg.substr(6));
+        }
+        else if (arg.substr(0, 8) == "--chunk=")
+        {
+            params.chunk = std::stoul(arg.substr(8));
+        }
+        else
+        {
+            throw ConfigurationException("Unknown argument: " + arg);
+        }
+    }
+
+    if (params.trace_file.empty())
+    {
+        throw ConfigurationException("--trace-file is required");
+    }
+    if (params.threads == 0)
+    {
+        params.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (params.chunk == 0)
+    {
+        throw std::invalid_argument("Chunk size must be > 0");
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Прочитать трассу и напечатать отчет
+ * @throws StorageException если трассу не удалось прочитать
+ */
+void analyzeTrace(const StatsParameters& params)
+{
+    using Clock = std::chrono::steady_clock;
+
+    stats::ReuseOptions options;
+    options.rate = params.sample_rate;
+    options.max_tracked = params.max_keys;
+    options.windows = params.windows;
+    stats::ReuseProfiler<int> profiler(options);
+
+    std::vector<stats::HyperLogLog<int>> distinct(params.threads);
+    std::vector<stats::SpaceSaving<int>> popular(params.threads, stats::SpaceSaving<int>(params.top));
+
+    trace::TraceReader reader(params.trace_file);
+    std::vector<int> chunk;
+    uint64_t offset = 0;
+
+    auto start = Clock::now();
+    while (reader.read(chunk, params.chunk) > 0)
+    {
+        // расстояния зависят от порядка запросов и считаются одним потоком
+        std::thread reuse([&]() {
+            for (size_t i = 0; i < chunk.size(); i++)
+            {
+                profiler.access(chunk[i], offset + i);
+            }
+        });
+
+        std::vector<std::thread> counters;
+        for (unsigned t = 0; t < params.threads; t++)
+        {
+            counters.emplace_back([&, t]() {
+                size_t begin = chunk.size() * t / params.threads;
+                size_t end = chunk.size() * (t + 1) / params.threads;
+                for (size_t i = begin; i < end; i++)
+                {
+                    distinct[t].add(chunk[i]);
+                    popular[t].add(chunk[i]);
+                }
+            });
+        }
+
+        reuse.join();
+        for (std::thread& thread : counters)
+        {
+            thread.join();
+        }
+        offset += chunk.size();
+    }
+    double elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (unsigned t = 1; t < params.threads; t++)
+    {
+        distinct[0].merge(distinct[t]);
+        popular[0].merge(popular[t]);
+    }
+
+    std::vector<uint64_t> counts = popular[0].reliableCounts();
+
+    std::cout << "\nTrace " << params.trace_file << (reader.binary() ? " (binary)" : " (text)") << std::endl;
+    std::cout << std::string(60, '=') << std::endl;
+    std::cout << std::left << std::fixed << std::setprecision(2);
+    std::cout << std::setw(28) << "Requests:" << offset << std::endl;
+    std::cout << std::setw(28) << "Distinct keys:" << std::setprecision(0) << distinct[0].estimate()
+              << " (+/- " << std::setprecision(1) << distinct[0].relativeError() * 100 << "%)" << std::endl;
+    std::cout << std::setw(28) << "Zipf skew (alpha):";
+    if (counts.size() < 2)
+    {
+        std::cout << "n/a (no key stands out of the heavy hitter summary)" << std::endl;
+    }
+    else
+    {
+        std::cout << std::setprecision(3) << stats::fitZipf(counts) << " (top " << counts.size() << " keys)" << std::endl;
+    }
+    std::cout << std::setw(28) << "One-hit wonders:" << std::setprecision(2) << profiler.oneHitFraction() * 100
+              << "% of keys" << std::endl;
+    std::cout << std::setw(28) << "Sample rate:" << std::setprecision(4) << profiler.rate()
+              << " (" << profiler.trackedKeys() << " keys)" << std::endl;
+    std::cout << std::setw(28) << "Time:" << std::setprecision(2) << elapsed_s << " s, "
+              << params.threads << " counting threads" << std::endl;
+
+    std::cout << "\nReuse distance (distinct keys between accesses)" << std::endl;
+    std::cout << std::string(60, '-') << std::endl;
+    std::cout << std::setw(22) << "Distance" << std::setw(16) << "References" << std::setw(10) << "Share"
+              << "LRU hit rate" << std::endl;
+
+    const double total = std::max(profiler.references(), 1.0);
+    const auto& histogram = profiler.histogram();
+    double cumulative = 0.0;
+    for (size_t bin = 0; bin < histogram.size(); bin++)
+    {
+        std::string range = bin == 0 ? "0" : "[" + std::to_string(1ULL << (bin - 1)) + ", " + std::to_string(1ULL << bin) + ")";
+        cumulative += histogram[bin];
+        std::cout << std::setw(22) << range << std::setw(16) << std::setprecision(0) << histogram[bin]
+                  << std::setw(10) << std::setprecision(2) << histogram[bin] / total * 100
+                  << cumulative / total * 100 << "% at size " << (1ULL << bin) << std::endl;
+    }
+    std::cout << std::setw(22) << "cold" << std::setw(16) << std::setprecision(0) << profiler.coldMisses()
+              << std::setw(10) << std::setprecision(2) << profiler.coldMisses() / total * 100 << std::endl;
+
+    std::cout << "\nWorking set (distinct keys in the last W requests)" << std::endl;
+    std::cout << std::string(60, '-') << std::endl;
+    std::cout << std::setw(16) << "Window" << std::setw(16) << "Mean" << "Max" << std::endl;
+    for (const auto& window : profiler.workingSets())
+    {
+        std::cout << std::setw(16) << window.window << std::setw(16) << std::setprecision(0) << window.mean
+                  << window.max << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    StatsParameters params;
+
+    try
+    {
+        getParameters(argc, argv, params);
+        if (params.help)
+        {
+            return 0;
+        }
+
+        analyzeTrace(params);
+    }
+    catch (const std::invalid_argument& e)
+    {
+        std::cerr << "Invalid argument - " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const ConfigurationException& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+    catch (const StorageException& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Unexpected exception - " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
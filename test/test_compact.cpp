@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+#include <map>
+#include "LFUCache.h"
+#include "CompactLFUCache.h"
+#include "global.h"
+
+using namespace testing;
+
+class CompactLFUCacheTest : public Test
+{
+protected:
+    void SetUp() override {}
+    
+    void TearDown() override {}
+};
+
+namespace
+{
+    using Compact = lfu::CompactLFUCache<int, int>;
+
+    /**
+     * @brief Хеш, сводящий все ключи в одну цепочку пробирования
+     */
+    struct CollidingHash
+    {
+        size_t operator()(int) const { return 42; }
+    };
+}
+
+TEST_F(CompactLFUCacheTest, MatchesLFUCacheBelowSaturation)
+{
+    std::mt19937 gen(21);
+    for (int round = 0; round < 20; round++)
+    {
+        const int pages = 20 + round * 10;
+        const size_t capacity = 5 + round;
+        std::uniform_int_distribution<int> dist(-pages, pages);
+
+        lfu::LFUCache<int, int> reference(capacity, slow_get_page_int);
+        Compact compact(capacity, slow_get_page_int);
+        std::map<int, int> accesses;
+
+        for (int i = 0; i < 4000; i++)
+        {
+            int key = dist(gen);
+            if (++accesses[key] >= Compact::kMaxFrequency)
+            {
+                continue;
+            }
+
+            ASSERT_EQ(compact.contains(key), reference.contains(key));
+            if (reference.contains(key))
+            {
+                ASSERT_EQ(compact.get(key), reference.get(key));
+            }
+            else
+            {
+                ASSERT_EQ(compact.put(key), reference.put(key));
+            }
+        }
+
+        while (!reference.empty())
+        {
+            ASSERT_EQ(compact.evict(), reference.evict());
+        }
+        EXPECT_TRUE(compact.empty());
+    }
+}
+
+TEST_F(CompactLFUCacheTest, FrequencySaturates)
+{
+    Compact cache(3, slow_get_page_int);
+    cache.put(1);
+    cache.put(2);
+    for (int i = 0; i < 1000; i++)
+    {
+        cache.get(1);
+        cache.get(2);
+    }
+    EXPECT_EQ(cache.frequencyOf(1), Compact::kMaxFrequency);
+
+    // среди насыщенных вытесняется давнее всех использованный
+    cache.get(1);
+    cache.put(3);
+    EXPECT_EQ(cache.evict().first, 3);
+    EXPECT_EQ(cache.evict().first, 2);
+    EXPECT_EQ(cache.evict().first, 1);
+    EXPECT_THROW(cache.evict(), CacheOperationException);
+    EXPECT_THROW(cache.get(1), std::out_of_range);
+}
+
+TEST_F(CompactLFUCacheTest, BackwardShiftKeepsChainsReachable)
+{
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<int> dist(0, 200);
+
+    lfu::CompactLFUCache<int, int, CollidingHash> colliding(16, slow_get_page_int);
+    lfu::LFUCache<int, int> reference(16, slow_get_page_int);
+
+    for (int i = 0; i < 5000; i++)
+    {
+        int key = dist(gen);
+        ASSERT_EQ(colliding.contains(key), reference.contains(key));
+        if (reference.contains(key))
+        {
+            colliding.get(key);
+            reference.get(key);
+        }
+        else
+        {
+            colliding.put(key);
+            reference.put(key);
+        }
+    }
+    EXPECT_EQ(colliding.size(), reference.size());
+}
+
+TEST_F(CompactLFUCacheTest, NodesAreReusedAndMemoryIsBounded)
+{
+    const size_t capacity = 1000;
+    Compact cache(capacity, slow_get_page_int);
+    for (int key = 0; key < 100000; key++)
+    {
+        cache.put(key);
+    }
+    EXPECT_EQ(cache.size(), capacity);
+
+    // узел <int, int> - 20 байт, таблица ключей - 2..4 индекса по 4 байта на элемент
+    EXPECT_LE(cache.memoryUsage(), capacity * (20 + 16) + 2048);
+
+    cache.clear();
+    EXPECT_TRUE(cache.empty());
+    EXPECT_FALSE(cache.contains(99999));
+    cache.put(7);
+    EXPECT_EQ(cache.get(7), 7);
+
+    EXPECT_THROW(Compact(0, slow_get_page_int), std::invalid_argument);
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <map>
+#include <random>
+#include <cstdint>
+#include "GDSFCache.h"
+#include "OptimalCache.h"
+#include "global.h"
+
+using namespace testing;
+
+class CostTest : public Test
+{
+protected:
+    void SetUp() override {}
+    
+    void TearDown() override {}
+};
+
+namespace
+{
+    /**
+     * @brief Загрузчик, сдвигающий виртуальные часы на заданную стоимость ключа
+     */
+    struct VirtualLoader
+    {
+        uint64_t now = 0;
+        std::map<int, uint64_t> costs;
+        uint64_t default_cost = 1;
+
+        int load(int key)
+        {
+            auto it = costs.find(key);
+            now += it == costs.end() ? default_cost : it->second;
+            return key;
+        }
+    };
+}
+
+TEST_F(CostTest, CostIsMeasuredFromLoader)
+{
+    VirtualLoader loader;
+    loader.costs = {{1, 40}, {2, 7}};
+
+    lfu::GDSFCache<int, int> cache(4, [&](int key) { return loader.load(key); });
+    cache.setClock([&]() { return loader.now; });
+
+    cache.put(1);
+    cache.put(2);
+    EXPECT_EQ(cache.costOf(1), 40u);
+    EXPECT_EQ(cache.costOf(2), 7u);
+    EXPECT_EQ(cache.missCost(), 47u);
+    EXPECT_EQ(cache.loadCount(), 2u);
+    EXPECT_THROW(cache.costOf(3), std::out_of_range);
+}
+
+TEST_F(CostTest, ExpensiveKeySurvivesCheapOnes)
+{
+    VirtualLoader loader;
+    loader.costs = {{1, 100}};
+
+    lfu::GDSFCache<int, int> cache(2, [&](int key) { return loader.load(key); });
+    cache.setClock([&]() { return loader.now; });
+
+    cache.put(1);
+    cache.put(2);
+    cache.put(3);
+
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(3));
+    EXPECT_EQ(cache.inflation(), 1u);
+}
+
+TEST_F(CostTest, InflationAgesUnusedKeys)
+{
+    VirtualLoader loader;
+    loader.costs = {{1, 100}};
+
+    lfu::GDSFCache<int, int> cache(2, [&](int key) { return loader.load(key); });
+    cache.setClock([&]() { return loader.now; });
+
+    cache.put(1);
+    int key = 2;
+    while (cache.contains(1) && key < 1000)
+    {
+        cache.put(key++);
+    }
+
+    // без обращений дорогой ключ держится, пока инфляция не догонит его приоритет
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_GE(cache.inflation(), 100u);
+    EXPECT_LE(key, 110);
+}
+
+TEST_F(CostTest, FrequencyRaisesPriority)
+{
+    VirtualLoader loader;
+
+    lfu::GDSFCache<int, int> cache(2, [&](int key) { return loader.load(key); });
+    cache.setClock([&]() { return loader.now; });
+
+    cache.put(1);
+    cache.put(2);
+    cache.get(1);
+    cache.get(1);
+    cache.put(3);
+
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+
+    auto victim = cache.evict();
+    EXPECT_EQ(victim.first, 3);
+    cache.clear();
+    EXPECT_TRUE(cache.empty());
+    EXPECT_THROW(cache.evict(), CacheOperationException);
+}
+
+TEST_F(CostTest, CostAwareOptimalSavesExpensiveKey)
+{
+    VirtualLoader loader;
+    loader.costs = {{1, 100}};
+    const std::vector<int> requests = {1, 2, 3, 2, 1};
+
+    auto run = [&](bool cost_aware)
+    {
+        opt::OptimalCache<int, int> cache(2, [&](int key) { return loader.load(key); });
+        cache.setClock([&]() { return loader.now; });
+        cache.setCostAware(cost_aware);
+        cache.preprocessRequests(requests);
+        for (int key : requests)
+        {
+            cache.step(key);
+        }
+        return cache.getMissCost();
+    };
+
+    // Belady вытесняет ключ 1 (он дальше), учет стоимости - дешевый ключ 2
+    EXPECT_EQ(run(false), 202u);
+    EXPECT_EQ(run(true), 103u);
+}
+
+TEST_F(CostTest, UniformCostMatchesBelady)
+{
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int> dist(1, 60);
+    std::vector<int> requests;
+    for (int i = 0; i < 3000; i++)
+    {
+        requests.push_back(dist(gen));
+    }
+
+    VirtualLoader loader;
+    auto run = [&](bool cost_aware)
+    {
+        opt::OptimalCache<int, int> cache(16, [&](int key) { return loader.load(key); });
+        cache.setClock([&]() { return loader.now; });
+        cache.setCostAware(cost_aware);
+        cache.preprocessRequests(requests);
+        for (int key : requests)
+        {
+            cache.step(key);
+        }
+        return std::make_pair(cache.getHitCount(), cache.getMissCost());
+    };
+
+    auto belady = run(false);
+    auto cost_aware = run(true);
+    EXPECT_EQ(belady.first, cost_aware.first);
+    EXPECT_EQ(belady.second, cost_aware.second);
+    EXPECT_EQ(belady.second, requests.size() - belady.first);
+}
+
+TEST_F(CostTest, OptimalReadsClockOnlyWhenTrackingCost)
+{
+    VirtualLoader loader;
+    loader.costs = {{1, 10}};
+    const std::vector<int> requests = {1, 2, 1, 3};
+    size_t clock_calls = 0;
+
+    opt::OptimalCache<int, int> cache(2, [&](int key) { return loader.load(key); });
+    cache.setClock([&]() { clock_calls++; return loader.now; });
+    cache.setCostTracking(false);
+    cache.preprocessRequests(requests);
+    for (int key : requests)
+    {
+        cache.step(key);
+    }
+    EXPECT_EQ(clock_calls, 0u);
+    EXPECT_EQ(cache.getMissCost(), 0u);
+
+    cache.clear();
+    cache.setCostTracking(true);
+    cache.preprocessRequests(requests);
+    for (int key : requests)
+    {
+        cache.step(key);
+    }
+    EXPECT_EQ(clock_calls, 6u);
+    EXPECT_EQ(cache.getMissCost(), 12u);
+}
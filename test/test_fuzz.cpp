@@ -0,0 +1,493 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <limits>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include "LFUCache.h"
+#include "OptimalCache.h"
+#include "global.h"
+
+using namespace testing;
+
+class FuzzTest : public Test
+{
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+};
+
+namespace
+{
+    /**
+     * @brief Операция трассы: обращение к ключу или смена вместимости (resize > 0)
+     */
+    struct Op
+    {
+        int key;
+        size_t resize;
+    };
+
+    struct Trace
+    {
+        size_t capacity;
+        std::vector<Op> ops;
+    };
+
+    std::string describe(const Trace& trace)
+    {
+        std::ostringstream out;
+        out << "capacity " << trace.capacity << ", ops:";
+        for (const Op& op : trace.ops)
+        {
+            if (op.resize > 0)
+            {
+                out << " resize(" << op.resize << ")";
+            }
+            else
+            {
+                out << " " << op.key;
+            }
+        }
+        return out.str();
+    }
+
+    std::vector<int> keysOf(const Trace& trace)
+    {
+        std::vector<int> keys;
+        for (const Op& op : trace.ops)
+        {
+            if (op.resize == 0)
+            {
+                keys.push_back(op.key);
+            }
+        }
+        return keys;
+    }
+
+    size_t iterations()
+    {
+        const char* env = std::getenv("LFU_FUZZ_ITERATIONS");
+        return env != nullptr ? std::strtoul(env, nullptr, 10) : 400;
+    }
+
+    /**
+     * @brief Эталонный LFU за O(n): вытесняется элемент с наименьшей частотой,
+     * среди них - тот, к которому дольше всего не обращались
+     */
+    class ReferenceLFU
+    {
+    private:
+        struct Entry
+        {
+            int key;
+            int frequency;
+            size_t touched;
+        };
+
+        size_t capacity_;
+        size_t clock_;
+        std::vector<Entry> entries_;
+
+        void evict()
+        {
+            auto victim = std::min_element(entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) {
+                return a.frequency != b.frequency ? a.frequency < b.frequency : a.touched < b.touched;
+            });
+            entries_.erase(victim);
+        }
+
+    public:
+        explicit ReferenceLFU(size_t capacity) : capacity_(capacity), clock_(0) {}
+
+        bool access(int key)
+        {
+            clock_++;
+            for (Entry& entry : entries_)
+            {
+                if (entry.key == key)
+                {
+                    entry.frequency++;
+                    entry.touched = clock_;
+                    return true;
+                }
+            }
+
+            if (entries_.size() >= capacity_)
+            {
+                evict();
+            }
+            entries_.push_back(Entry{key, 1, clock_});
+            return false;
+        }
+
+        void resize(size_t capacity)
+        {
+            capacity_ = capacity;
+            while (entries_.size() > capacity_)
+            {
+                evict();
+            }
+        }
+
+        std::vector<int> residents() const
+        {
+            std::vector<int> keys;
+            for (const Entry& entry : entries_)
+            {
+                keys.push_back(entry.key);
+            }
+            return keys;
+        }
+    };
+
+    /**
+     * @brief Эталонный алгоритм Belady перебором: при вытеснении следующее обращение
+     * каждого резидента ищется просмотром остатка трассы
+     */
+    class ReferenceBelady
+    {
+    private:
+        size_t capacity_;
+        const std::vector<int>& requests_;
+        std::vector<int> residents_;
+
+    public:
+        ReferenceBelady(size_t capacity, const std::vector<int>& requests) : capacity_(capacity), requests_(requests) {}
+
+        size_t nextUse(int key, size_t after) const
+        {
+            for (size_t i = after + 1; i < requests_.size(); i++)
+            {
+                if (requests_[i] == key)
+                {
+                    return i;
+                }
+            }
+            return std::numeric_limits<size_t>::max();
+        }
+
+        bool access(size_t step)
+        {
+            int key = requests_[step];
+            if (std::find(residents_.begin(), residents_.end(), key) != residents_.end())
+            {
+                return true;
+            }
+
+            if (residents_.size() >= capacity_)
+            {
+                auto victim = std::max_element(residents_.begin(), residents_.end(), [&](int a, int b) {
+                    return nextUse(a, step) < nextUse(b, step);
+                });
+                residents_.erase(victim);
+            }
+            residents_.push_back(key);
+            return false;
+        }
+
+        const std::vector<int>& residents() const { return residents_; }
+    };
+
+    /**
+     * @brief Прогнать трассу через LFUCache и эталон
+     * @return Описание первого расхождения или пусто
+     */
+    template<typename KeyPolicy>
+    std::optional<std::string> checkLFU(const Trace& trace)
+    {
+        lfu::LFUCache<int, int, KeyPolicy> cache(trace.capacity, slow_get_page_int);
+        cache.setResizeChunk(std::numeric_limits<size_t>::max());
+        ReferenceLFU reference(trace.capacity);
+
+        for (size_t i = 0; i < trace.ops.size(); i++)
+        {
+            const Op& op = trace.ops[i];
+            std::ostringstream where;
+            where << "op " << i << ": ";
+
+            if (op.resize > 0)
+            {
+                cache.resize(op.resize);
+                reference.resize(op.resize);
+            }
+            else
+            {
+                bool hit = true;
+                try
+                {
+                    if (cache.get(op.key) != op.key)
+                    {
+                        return where.str() + "wrong value for key " + std::to_string(op.key);
+                    }
+                }
+                catch (const std::out_of_range&)
+                {
+                    hit = false;
+                    cache.put(op.key);
+                }
+
+                if (hit != reference.access(op.key))
+                {
+                    return where.str() + (hit ? "unexpected hit on " : "unexpected miss on ") + std::to_string(op.key);
+                }
+            }
+
+            std::vector<int> residents = reference.residents();
+            if (cache.size() != residents.size())
+            {
+                return where.str() + "size " + std::to_string(cache.size()) + ", expected " + std::to_string(residents.size());
+            }
+            for (int key : residents)
+            {
+                if (!cache.contains(key))
+                {
+                    return where.str() + "key " + std::to_string(key) + " should be resident";
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Прогнать трассу через OptimalCache и эталон
+     * @details Число попаданий у Belady не зависит от выбора среди элементов без будущих обращений,
+     * поэтому резидентные множества сравниваются только по ключам, к которым еще будут обращения
+     */
+    template<typename KeyPolicy>
+    std::optional<std::string> checkOptimal(const Trace& trace)
+    {
+        std::vector<int> requests = keysOf(trace);
+        if (requests.empty())
+        {
+            return std::nullopt;
+        }
+
+        opt::OptimalCache<int, int, KeyPolicy> cache(trace.capacity, slow_get_page_int);
+        cache.preprocessRequests(requests);
+        ReferenceBelady reference(trace.capacity, requests);
+
+        for (size_t i = 0; i < requests.size(); i++)
+        {
+            std::ostringstream where;
+            where << "request " << i << ": ";
+
+            bool hit = cache.step(requests[i]);
+            if (hit != reference.access(i))
+            {
+                return where.str() + (hit ? "unexpected hit on " : "unexpected miss on ") + std::to_string(requests[i]);
+            }
+            if (cache.getCurrentSize() != reference.residents().size())
+            {
+                return where.str() + "size " + std::to_string(cache.getCurrentSize()) + ", expected " +
+                       std::to_string(reference.residents().size());
+            }
+
+            for (int key : reference.residents())
+            {
+                if (reference.nextUse(key, i) != std::numeric_limits<size_t>::max() && !cache.contains(key))
+                {
+                    return where.str() + "key " + std::to_string(key) + " with a future use should be resident";
+                }
+            }
+            for (const auto& entry : cache.getCacheContents())
+            {
+                if (entry.second != entry.first)
+                {
+                    return where.str() + "wrong value for key " + std::to_string(entry.first);
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Уменьшить падающую трассу (ddmin по операциям, затем уменьшение вместимости и ключей)
+     * @param trace Трасса, на которой check возвращает ошибку
+     * @param check Проверка
+     * @return Локально минимальная трасса, на которой проверка все еще падает
+     */
+    Trace shrink(Trace trace, const std::function<std::optional<std::string>(const Trace&)>& check)
+    {
+        auto fails = [&](const Trace& candidate) { return check(candidate).has_value(); };
+
+        // меньшая вместимость позволяет убрать больше операций и наоборот, поэтому до неподвижной точки
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+
+            size_t granularity = 2;
+            while (trace.ops.size() >= 2)
+            {
+                size_t chunk = std::max<size_t>(1, trace.ops.size() / granularity);
+                bool reduced = false;
+
+                for (size_t begin = 0; begin < trace.ops.size(); begin += chunk)
+                {
+                    Trace candidate = trace;
+                    size_t end = std::min(begin + chunk, candidate.ops.size());
+                    candidate.ops.erase(candidate.ops.begin() + begin, candidate.ops.begin() + end);
+                    if (!candidate.ops.empty() && fails(candidate))
+                    {
+                        trace = std::move(candidate);
+                        granularity = std::max<size_t>(granularity - 1, 2);
+                        reduced = true;
+                        changed = true;
+                        break;
+                    }
+                }
+
+                if (!reduced)
+                {
+                    if (chunk == 1)
+                    {
+                        break;
+                    }
+                    granularity = std::min(granularity * 2, trace.ops.size());
+                }
+            }
+
+            while (trace.capacity > 1)
+            {
+                Trace candidate = trace;
+                candidate.capacity--;
+                if (!fails(candidate))
+                {
+                    break;
+                }
+                trace = std::move(candidate);
+                changed = true;
+            }
+        }
+
+        // ключи сводятся к наименьшим значениям, не меняя их попарного равенства
+        std::vector<int> distinct = keysOf(trace);
+        std::sort(distinct.begin(), distinct.end());
+        distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+        Trace renamed = trace;
+        for (Op& op : renamed.ops)
+        {
+            if (op.resize == 0)
+            {
+                op.key = static_cast<int>(std::lower_bound(distinct.begin(), distinct.end(), op.key) - distinct.begin());
+            }
+        }
+        if (fails(renamed))
+        {
+            trace = std::move(renamed);
+        }
+
+        return trace;
+    }
+
+    /**
+     * @brief Случайная трасса: равномерные, перекошенные и циклические обращения, иногда resize
+     * @param negative_keys Разрешить отрицательные ключи (не для DenseKeys)
+     * @param with_resize Добавлять смену вместимости
+     */
+    Trace generate(std::mt19937_64& gen, bool negative_keys, bool with_resize)
+    {
+        Trace trace;
+        trace.capacity = 1 + gen() % 8;
+        int key_range = 1 + static_cast<int>(gen() % 24);
+        int low = negative_keys ? -key_range / 2 : 0;
+        size_t length = 1 + gen() % 160;
+        int pattern = static_cast<int>(gen() % 3);
+
+        for (size_t i = 0; i < length; i++)
+        {
+            if (with_resize && gen() % 40 == 0)
+            {
+                trace.ops.push_back(Op{0, 1 + gen() % 8});
+                continue;
+            }
+
+            int offset = 0;
+            if (pattern == 0)
+            {
+                offset = static_cast<int>(gen() % key_range);
+            }
+            else if (pattern == 1)
+            {
+                // квадрат равномерного числа смещает обращения к малым ключам
+                double u = std::uniform_real_distribution<double>(0.0, 1.0)(gen);
+                offset = std::min(key_range - 1, static_cast<int>(u * u * key_range));
+            }
+            else
+            {
+                offset = static_cast<int>(i % key_range);
+            }
+            trace.ops.push_back(Op{low + offset, 0});
+        }
+        return trace;
+    }
+
+    /**
+     * @brief Прогнать много случайных трасс, на первой падающей уменьшить ее и сообщить
+     */
+    void fuzz(uint64_t seed, bool negative_keys, bool with_resize,
+              const std::function<std::optional<std::string>(const Trace&)>& check)
+    {
+        std::mt19937_64 gen(seed);
+        for (size_t i = 0; i < iterations(); i++)
+        {
+            Trace trace = generate(gen, negative_keys, with_resize);
+            if (check(trace))
+            {
+                Trace minimal = shrink(trace, check);
+                FAIL() << "iteration " << i << ": " << *check(minimal) << "\nminimal trace: " << describe(minimal)
+                       << "\noriginal trace: " << describe(trace);
+            }
+        }
+    }
+}
+
+TEST_F(FuzzTest, ShrinkFindsMinimalTrace)
+{
+    // падает, если ключ 7 встречается дважды при вместимости >= 2
+    auto check = [](const Trace& trace) -> std::optional<std::string> {
+        std::vector<int> keys = keysOf(trace);
+        if (trace.capacity >= 2 && std::count(keys.begin(), keys.end(), 7) >= 2)
+        {
+            return std::string("seven twice");
+        }
+        return std::nullopt;
+    };
+
+    Trace trace{6, {}};
+    for (int i = 0; i < 50; i++)
+    {
+        trace.ops.push_back(Op{i % 9, 0});
+    }
+
+    Trace minimal = shrink(trace, check);
+    EXPECT_EQ(minimal.capacity, 2u);
+    ASSERT_EQ(minimal.ops.size(), 2u);
+    EXPECT_EQ(minimal.ops[0].key, minimal.ops[1].key);
+}
+
+TEST_F(FuzzTest, LFUMatchesReference)
+{
+    fuzz(1, true, true, checkLFU<keys::HashKeys>);
+}
+
+TEST_F(FuzzTest, DenseLFUMatchesReference)
+{
+    fuzz(2, false, true, checkLFU<keys::DenseKeys>);
+}
+
+TEST_F(FuzzTest, OptimalMatchesBelady)
+{
+    fuzz(3, true, false, checkOptimal<keys::HashKeys>);
+}
+
+TEST_F(FuzzTest, DenseOptimalMatchesBelady)
+{
+    fuzz(4, false, false, checkOptimal<keys::DenseKeys>);
+}
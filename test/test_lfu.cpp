@@ -1,5 +1,7 @@
 #include <gtest/gtest.h> //TODO - написать в readme
 #include <vector>
+#include <cstdio>
+#include <fstream>
 #include "LFUCache.h"
 #include "global.h"
 
@@ -52,4 +54,193 @@ TEST_F(LFUCacheTest, ClearCache)
     EXPECT_TRUE(cache.empty());
 }
 
+TEST_F(LFUCacheTest, SnapshotRestore)
+{
+    const std::string path = "test_lfu.snapshot";
+    lfu::LFUCache<int, int> cache(3, slow_get_page_int);
+    
+    cache.put(1);
+    cache.put(2);
+    cache.put(3);
+    cache.get(1);
+    cache.get(1);
+    cache.get(3);
+    cache.saveSnapshot(path);
+    
+    lfu::LFUCache<int, int> restored(3, slow_get_page_int);
+    restored.loadSnapshot(path);
+    std::remove(path.c_str());
+    
+    EXPECT_EQ(restored.size(), 3);
+    EXPECT_EQ(restored.get(3), 3);
+    
+    restored.put(4);
+    EXPECT_THROW(restored.get(2), std::out_of_range);
+    EXPECT_NO_THROW(restored.get(1));
+    EXPECT_NO_THROW(restored.get(3));
+}
+
+TEST_F(LFUCacheTest, SnapshotRejectsBadInput)
+{
+    const std::string path = "test_lfu_bad.snapshot";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a snapshot at all, just some text that is long enough";
+    }
+    
+    lfu::LFUCache<int, int> cache(2, slow_get_page_int);
+    EXPECT_THROW(cache.loadSnapshot(path), StorageException);
+    
+    lfu::LFUCache<int, int> big(4, slow_get_page_int);
+    big.put(1);
+    big.put(2);
+    big.put(3);
+    big.saveSnapshot(path);
+    EXPECT_THROW(cache.loadSnapshot(path), StorageException);
+    std::remove(path.c_str());
+}
+
+TEST_F(LFUCacheTest, SnapshotRejectsBadRecords)
+{
+    const std::string path = "test_lfu_records.snapshot";
+    lfu::LFUCache<int, int> source(3, slow_get_page_int);
+    source.put(1);
+    source.put(2);
+    source.get(2);
+    source.saveSnapshot(path);
+
+    // заголовок <int, int>: 48 байт, min_frequency по смещению 32; запись: 24 байта, частота по смещению 8
+    auto patch = [&](std::streamoff offset, auto value)
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    patch(32, int64_t{1000});
+    lfu::LFUCache<int, int> restored(3, slow_get_page_int);
+    restored.loadSnapshot(path);
+    restored.put(3);
+    restored.put(4);
+    EXPECT_EQ(restored.size(), 3);
+    EXPECT_FALSE(restored.contains(1));
+    EXPECT_TRUE(restored.contains(2));
+
+    patch(48 + 8, int32_t{0});
+    EXPECT_THROW(restored.loadSnapshot(path), StorageException);
+    EXPECT_EQ(restored.size(), 3);
+    EXPECT_TRUE(restored.contains(4));
+
+    patch(48 + 8, int32_t{1});
+    patch(16, uint64_t{2} + (uint64_t{1} << 61));
+    EXPECT_THROW(restored.loadSnapshot(path), StorageException);
+    std::remove(path.c_str());
+}
+
+TEST_F(LFUCacheTest, DenseKeysMatchHashKeys)
+{
+    lfu::LFUCache<int, int> hashed(4, slow_get_page_int);
+    lfu::LFUCache<int, int, keys::DenseKeys> dense(4, slow_get_page_int);
+    std::vector<int> requests = {1, 2, 3, 1, 4, 5, 1, 2, 6, 0, 7, 3, 3, 8, 1, 9, 0, 0};
+    
+    for (int page : requests)
+    {
+        bool hashed_hit = true;
+        bool dense_hit = true;
+        try { hashed.get(page); } catch (const std::out_of_range&) { hashed_hit = false; hashed.put(page); }
+        try { dense.get(page); } catch (const std::out_of_range&) { dense_hit = false; dense.put(page); }
+        
+        EXPECT_EQ(hashed_hit, dense_hit) << "page " << page;
+    }
+    
+    EXPECT_EQ(hashed.size(), dense.size());
+
+    // отрицательный ключ отклоняется до вытеснения и загрузки
+    std::vector<int> resident;
+    for (int page = 0; page < 10; page++)
+    {
+        if (dense.contains(page))
+        {
+            resident.push_back(page);
+        }
+    }
+    ASSERT_EQ(resident.size(), dense.size());
+
+    EXPECT_THROW(dense.put(-1), std::out_of_range);
+    EXPECT_THROW(dense.update(-1, 5), std::out_of_range);
+    EXPECT_EQ(dense.size(), resident.size());
+    for (int page : resident)
+    {
+        EXPECT_TRUE(dense.contains(page)) << "page " << page;
+    }
+
+    dense.put(100);
+    EXPECT_EQ(dense.size(), resident.size());
+    while (!dense.empty())
+    {
+        dense.evict();
+    }
+    EXPECT_THROW(dense.evict(), CacheOperationException);
+}
+
+TEST_F(LFUCacheTest, ShrinkIsIncremental)
+{
+    lfu::LFUCache<int, int> cache(1000, slow_get_page_int);
+    for (int i = 0; i < 1000; i++)
+    {
+        cache.put(i);
+        if (i >= 900)
+        {
+            cache.get(i);
+        }
+    }
 
+    cache.setResizeChunk(64);
+    cache.resize(100);
+    EXPECT_EQ(cache.capacity(), 100u);
+    EXPECT_EQ(cache.size(), 1000u - 64u);
+    EXPECT_EQ(cache.shrinkPending(), 900u - 64u);
+
+    // каждая вставка вытесняет очередную порцию
+    cache.put(5000);
+    EXPECT_EQ(cache.size(), 1000u - 128u);
+
+    while (cache.resizeStep() > 0) {}
+    EXPECT_EQ(cache.size(), 100u);
+
+    // частые элементы пережили уменьшение
+    for (int i = 901; i < 1000; i++)
+    {
+        EXPECT_NO_THROW(cache.get(i)) << "page " << i;
+    }
+
+    cache.resize(200);
+    for (int i = 2000; i < 2100; i++)
+    {
+        cache.put(i);
+    }
+    EXPECT_EQ(cache.size(), 200u);
+}
+
+TEST_F(LFUCacheTest, MemoryPressure)
+{
+    lfu::LFUCache<int, int> cache(400, slow_get_page_int);
+    cache.setResizeChunk(SIZE_MAX);
+    for (int i = 0; i < 400; i++)
+    {
+        cache.put(i);
+    }
+
+    cache.onMemoryPressure(0.75);
+    EXPECT_EQ(cache.capacity(), 100u);
+    EXPECT_EQ(cache.size(), 100u);
+    EXPECT_EQ(cache.nominalCapacity(), 400u);
+
+    cache.onMemoryPressure(1.0);
+    EXPECT_EQ(cache.capacity(), 1u);
+
+    cache.onMemoryPressure(0.0);
+    EXPECT_EQ(cache.capacity(), 400u);
+    EXPECT_THROW(cache.onMemoryPressure(1.5), std::invalid_argument);
+    EXPECT_THROW(cache.setResizeChunk(0), std::invalid_argument);
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "LRUCache.h"
+#include "global.h"
+
+using namespace testing;
+
+class LRUCacheTest : public Test
+{
+protected:
+    void SetUp() override {}
+    
+    void TearDown() override {}
+};
+
+TEST_F(LRUCacheTest, Basic)
+{
+    lru::LRUCache<int, int> cache(2, slow_get_page_int);
+    
+    cache.put(1);
+    EXPECT_EQ(cache.get(1), 1);
+    EXPECT_THROW(cache.get(2), std::out_of_range);
+}
+
+TEST_F(LRUCacheTest, EvictsLeastRecentlyUsed)
+{
+    lru::LRUCache<int, int> cache(2, slow_get_page_int);
+    
+    cache.put(1);
+    cache.put(2);
+    cache.get(1);
+    cache.put(3);
+    
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_NO_THROW(cache.get(1));
+    EXPECT_THROW(cache.get(2), std::out_of_range);
+    EXPECT_NO_THROW(cache.get(3));
+}
@@ -1,6 +1,13 @@
 #include <gtest/gtest.h>
 #include <vector>
+#include <random>
+#include <limits>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
 #include "OptimalCache.h"
+#include "NextUseIndex.h"
 #include "global.h"
 
 
@@ -29,3 +36,164 @@ TEST_F(OptimalCacheTest, Basic)
     EXPECT_GT(hits, 0);
 }
 
+TEST_F(OptimalCacheTest, DenseKeysMatchHashKeys)
+{
+    opt::OptimalCache<int, int> hashed(3, slow_get_page_int);
+    opt::OptimalCache<int, int, keys::DenseKeys> dense(3, slow_get_page_int);
+    std::vector<int> requests = {1, 2, 3, 4, 1, 2, 5, 1, 2, 3, 4, 5, 6, 1, 6, 2};
+    
+    hashed.preprocessRequests(requests);
+    dense.preprocessRequests(requests);
+    
+    EXPECT_EQ(hashed.simulate(requests), dense.simulate(requests));
+    EXPECT_EQ(hashed.getCurrentSize(), dense.getCurrentSize());
+}
+
+TEST_F(OptimalCacheTest, EvictsFarthestNextUse)
+{
+    opt::OptimalCache<int, int> cache(2, slow_get_page_int);
+    std::vector<int> requests = {0, 1, 2, 0, 1, 0};
+    
+    cache.preprocessRequests(requests);
+    
+    EXPECT_EQ(cache.simulate(requests), 2);
+    EXPECT_TRUE(cache.contains(0));
+}
+
+TEST_F(OptimalCacheTest, ArgMaxKernelsAgree)
+{
+    std::mt19937_64 gen(7);
+    
+    for (size_t n : {1, 2, 3, 5, 8, 17, 64, 1000, 4099})
+    {
+        std::vector<size_t> data(n);
+        for (size_t& value : data)
+        {
+            value = gen() % 50;
+        }
+        data[n / 2] = std::numeric_limits<size_t>::max();
+        data[n - 1] = std::numeric_limits<size_t>::max();
+        
+        size_t expected = simd::argmaxScalar(data.data(), n);
+        EXPECT_EQ(simd::argmax(data.data(), n), expected) << "n = " << n;
+#ifdef ARGMAX_X86
+        if (__builtin_cpu_supports("sse4.2"))
+        {
+            EXPECT_EQ(simd::argmaxSSE42(data.data(), n), expected) << "n = " << n;
+        }
+        if (__builtin_cpu_supports("avx2"))
+        {
+            EXPECT_EQ(simd::argmaxAVX2(data.data(), n), expected) << "n = " << n;
+        }
+#endif
+    }
+}
+
+TEST_F(OptimalCacheTest, NextUseIndexStitchesSegments)
+{
+    std::mt19937_64 gen(11);
+    std::vector<int> requests(5000);
+    for (int& key : requests)
+    {
+        key = static_cast<int>(gen() % 97);
+    }
+
+    std::vector<uint64_t> expected(requests.size(), opt::NextUseIndex::kNever);
+    std::unordered_map<int, size_t> following;
+    for (size_t i = requests.size(); i-- > 0;)
+    {
+        auto it = following.find(requests[i]);
+        if (it != following.end())
+        {
+            expected[i] = it->second;
+        }
+        following[requests[i]] = i;
+    }
+
+    for (size_t threads : {1, 2, 3, 7, 64})
+    {
+        auto hashed = opt::NextUseIndex::build(requests, threads);
+        auto dense = opt::NextUseIndex::build<int, keys::DenseKeys>(requests, threads);
+        ASSERT_EQ(hashed->size(), requests.size());
+        for (size_t i = 0; i < requests.size(); i++)
+        {
+            ASSERT_EQ(hashed->next(i), expected[i]) << "threads = " << threads << ", i = " << i;
+            ASSERT_EQ(dense->next(i), expected[i]) << "threads = " << threads << ", i = " << i;
+        }
+    }
+}
+
+TEST_F(OptimalCacheTest, SharedIndexMatchesOwnPreprocessing)
+{
+    std::mt19937_64 gen(5);
+    std::vector<int> requests(2000);
+    for (int& key : requests)
+    {
+        key = static_cast<int>(gen() % 60);
+    }
+
+    auto index = opt::NextUseIndex::build(requests, 4);
+    for (size_t capacity : {1, 5, 20, 59})
+    {
+        opt::OptimalCache<int, int> own(capacity, slow_get_page_int);
+        opt::OptimalCache<int, int> shared(capacity, slow_get_page_int);
+        own.preprocessRequests(requests);
+        shared.setNextUseIndex(index);
+
+        EXPECT_EQ(own.simulate(requests), shared.simulate(requests)) << "capacity = " << capacity;
+        EXPECT_EQ(shared.getNextUseIndex(), index);
+    }
+    EXPECT_EQ(index.use_count(), 1);
+}
+
+TEST_F(OptimalCacheTest, StepPastTraceEndThrows)
+{
+    opt::OptimalCache<int, int> cache(2, slow_get_page_int);
+    std::vector<int> requests = {1, 2, 1};
+
+    EXPECT_THROW(cache.step(1), CacheOperationException);
+    EXPECT_THROW(cache.setNextUseIndex(nullptr), std::invalid_argument);
+
+    cache.preprocessRequests(requests);
+    for (int key : requests)
+    {
+        cache.step(key);
+    }
+    EXPECT_THROW(cache.step(2), CacheOperationException);
+    EXPECT_THROW(cache.simulate({1, 2}), CacheOperationException);
+    EXPECT_EQ(cache.simulate(requests), 1);
+}
+
+TEST_F(OptimalCacheTest, NextUseIndexRoundTrip)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "test_optimal.nextuse").string();
+    std::vector<int> requests = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
+
+    auto built = opt::NextUseIndex::build(requests, 3);
+    built->save(path);
+
+    auto loaded = opt::NextUseIndex::load(path, opt::NextUseIndex::traceHash(requests));
+    EXPECT_TRUE(loaded->mapped());
+    ASSERT_EQ(loaded->size(), built->size());
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        EXPECT_EQ(loaded->next(i), built->next(i));
+    }
+
+    std::vector<int> other = requests;
+    other.back() = 7;
+    EXPECT_THROW(opt::NextUseIndex::load(path, opt::NextUseIndex::traceHash(other)), StorageException);
+
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(sizeof(opt::NextUseHeader) + 2 * sizeof(uint64_t));
+        uint64_t garbage = 12345;
+        file.write(reinterpret_cast<const char*>(&garbage), sizeof(garbage));
+    }
+    EXPECT_THROW(opt::NextUseIndex::load(path, opt::NextUseIndex::traceHash(requests)), StorageException);
+
+    std::filesystem::resize_file(path, sizeof(opt::NextUseHeader) + 3);
+    EXPECT_THROW(opt::NextUseIndex::load(path, opt::NextUseIndex::traceHash(requests)), StorageException);
+
+    std::filesystem::remove(path);
+}
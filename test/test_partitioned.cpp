@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+#include "PartitionedCache.h"
+#include "global.h"
+
+using namespace testing;
+
+class PartitionedCacheTest : public Test
+{
+protected:
+    void SetUp() override {}
+    
+    void TearDown() override {}
+};
+
+TEST_F(PartitionedCacheTest, EqualInitialSplit)
+{
+    part::PartitionedCache<int, int> cache(10, 3, slow_get_page_int);
+    
+    EXPECT_EQ(cache.capacityOf(0) + cache.capacityOf(1) + cache.capacityOf(2), 10);
+    EXPECT_THROW(cache.access(3, 1), std::out_of_range);
+    EXPECT_THROW((part::PartitionedCache<int, int>(2, 3, slow_get_page_int)), ConfigurationException);
+}
+
+TEST_F(PartitionedCacheTest, CapacityMovesToTenantWithReuse)
+{
+    part::PartitionOptions options;
+    options.epoch_length = 200;
+    options.rebalance_step = 4;
+    part::PartitionedCache<int, int> cache(64, 2, slow_get_page_int, options);
+    
+    // арендатор 0 случайно читает 48 страниц, арендатор 1 - только новые страницы
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int> pages(0, 47);
+    int stream = 1000;
+    for (int i = 0; i < 20000; i++)
+    {
+        cache.access(0, pages(gen));
+        cache.access(1, stream++);
+    }
+    
+    EXPECT_EQ(cache.capacityOf(0) + cache.capacityOf(1), 64);
+    EXPECT_GE(cache.capacityOf(0), 48);
+    EXPECT_LE(cache.sizeOf(1), cache.capacityOf(1));
+    EXPECT_GT(cache.rebalanceCount(), 0);
+}
+
+TEST_F(PartitionedCacheTest, ShadowStateIsBoundedByStep)
+{
+    part::PartitionOptions options;
+    options.epoch_length = 1000000;
+    options.rebalance_step = 4;
+    part::PartitionedCache<int, int> cache(32, 2, slow_get_page_int, options);
+
+    for (int page = 0; page < 1000; page++)
+    {
+        cache.access(0, page);
+    }
+    EXPECT_EQ(cache.sizeOf(0), 16);
+    EXPECT_EQ(cache.ghostSizeOf(0), 4);
+    EXPECT_EQ(cache.ghostSizeOf(1), 0);
+
+    // в кэше 984..999, в теневом списке - последние вытесненные 980..983
+    EXPECT_TRUE(cache.access(0, 999));
+    EXPECT_FALSE(cache.access(0, 983));
+    EXPECT_FALSE(cache.access(0, 900));
+    EXPECT_EQ(cache.ghostSizeOf(0), 4);
+}
+
+TEST_F(PartitionedCacheTest, EvictionRankCountsNextVictims)
+{
+    lfu::LFUCache<int, int> cache(4, slow_get_page_int);
+    cache.put(1);
+    cache.put(2);
+    cache.put(3);
+    cache.put(4);
+    cache.get(1);
+    cache.get(1);
+    cache.get(3);
+
+    // порядок вытеснения: 2, 4, 3, 1
+    EXPECT_EQ(cache.evictionRank(2, 4), 0);
+    EXPECT_EQ(cache.evictionRank(4, 4), 1);
+    EXPECT_EQ(cache.evictionRank(3, 4), 2);
+    EXPECT_EQ(cache.evictionRank(1, 4), 3);
+    EXPECT_EQ(cache.evictionRank(1, 2), 2);
+    EXPECT_THROW(cache.evictionRank(5, 4), std::out_of_range);
+
+    size_t rank = 0;
+    EXPECT_FALSE(cache.evictionRank(5, 4, rank));
+    EXPECT_TRUE(cache.evictionRank(3, 4, rank));
+    EXPECT_EQ(rank, 2);
+}
+
+TEST_F(PartitionedCacheTest, EvictionRankWithSparseFrequencies)
+{
+    lfu::LFUCache<int, int> cache(3, slow_get_page_int);
+    cache.put(1);
+    cache.put(2);
+    cache.put(3);
+    for (int i = 0; i < 100; i++)
+    {
+        cache.get(3);
+    }
+    cache.get(2);
+
+    // частоты 1, 2 и 101: между ними пропуски длиннее числа частот
+    EXPECT_EQ(cache.evictionRank(1, 4), 0);
+    EXPECT_EQ(cache.evictionRank(2, 4), 1);
+    EXPECT_EQ(cache.evictionRank(3, 4), 2);
+    EXPECT_EQ(cache.evictionRank(3, 1), 1);
+}
+
+TEST_F(PartitionedCacheTest, TenantListenerIsChainedAfterGhostList)
+{
+    struct Recorder : lfu::EvictionListener<int, int>
+    {
+        std::vector<int> evicted;
+        void onEvict(const int& key, const int&, bool) override { evicted.push_back(key); }
+    };
+
+    part::PartitionOptions options;
+    options.epoch_length = 1000000;
+    options.rebalance_step = 2;
+    part::PartitionedCache<int, int> cache(4, 2, slow_get_page_int, options);
+    Recorder recorder;
+    cache.setEvictionListener(0, &recorder);
+    EXPECT_THROW(cache.setEvictionListener(2, &recorder), std::out_of_range);
+
+    for (int page = 0; page < 5; page++)
+    {
+        cache.access(0, page);
+        cache.access(1, page);
+    }
+
+    // уведомления получает и теневой список, и получатель арендатора 0
+    EXPECT_EQ(recorder.evicted, std::vector<int>({0, 1, 2}));
+    EXPECT_EQ(cache.ghostSizeOf(0), 2);
+    EXPECT_EQ(cache.ghostSizeOf(1), 2);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+#include "Shards.h"
+#include "LRUCache.h"
+#include "global.h"
+
+using namespace testing;
+
+class ShardsTest : public Test
+{
+protected:
+    void SetUp() override {}
+    
+    void TearDown() override {}
+};
+
+static double lruMissRatio(size_t cache_size, const std::vector<int>& requests)
+{
+    lru::LRUCache<int, int> cache(cache_size, slow_get_page_int);
+    size_t misses = 0;
+    
+    for (int page : requests)
+    {
+        try
+        {
+            cache.get(page);
+        }
+        catch (const std::out_of_range&)
+        {
+            misses++;
+            cache.put(page);
+        }
+    }
+    
+    return static_cast<double>(misses) / requests.size();
+}
+
+TEST_F(ShardsTest, SampleRateAndKeyConsistency)
+{
+    shards::SpatialSampler<int> sampler(0.25, 3);
+    std::vector<int> keys(100000);
+    for (int i = 0; i < static_cast<int>(keys.size()); i++)
+    {
+        keys[i] = i;
+    }
+    
+    std::vector<int> sampled = sampler.sample(keys);
+    EXPECT_NEAR(static_cast<double>(sampled.size()) / keys.size(), 0.25, 0.01);
+    
+    for (int key : sampled)
+    {
+        EXPECT_TRUE(sampler.keep(key));
+    }
+    EXPECT_EQ(sampler.scaleCacheSize(100), 25);
+    EXPECT_EQ(sampler.scaleCacheSize(1), 1);
+    EXPECT_THROW(shards::SpatialSampler<int>(0.0), ConfigurationException);
+}
+
+TEST_F(ShardsTest, EstimatesLRUMissRatio)
+{
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int> hot(1, 2000);
+    std::uniform_int_distribution<int> cold(1, 50000);
+    std::bernoulli_distribution pick_hot(0.7);
+    
+    std::vector<int> requests(200000);
+    for (int& page : requests)
+    {
+        page = pick_hot(gen) ? hot(gen) : cold(gen);
+    }
+    
+    double exact = lruMissRatio(2000, requests);
+    
+    std::vector<double> estimates;
+    for (uint64_t seed = 0; seed < 4; seed++)
+    {
+        shards::SpatialSampler<int> sampler(0.1, seed);
+        estimates.push_back(lruMissRatio(sampler.scaleCacheSize(2000), sampler.sample(requests)));
+    }
+    
+    shards::Estimate estimate = shards::summarize(estimates);
+    EXPECT_NEAR(estimate.mean, exact, 0.02);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include "LFUCache.h"
+#include "InternedCache.h"
+#include "StringArena.h"
+
+using namespace testing;
+
+class StringKeysTest : public Test
+{
+protected:
+    void SetUp() override {}
+    
+    void TearDown() override {}
+};
+
+namespace
+{
+    std::string url(int page)
+    {
+        return "https://cdn.example.com/assets/v2/page-" + std::to_string(page) + "/index.html";
+    }
+}
+
+TEST_F(StringKeysTest, TransparentLookup)
+{
+    size_t loads = 0;
+    lfu::LFUCache<std::string, size_t, keys::StringKeys> cache(2, [&](const std::string& key)
+    {
+        loads++;
+        return key.size();
+    });
+
+    const std::string first = url(1);
+    cache.put(first);
+
+    std::string_view view = first;
+    EXPECT_TRUE(cache.contains(view));
+    EXPECT_EQ(cache.get(view), first.size());
+    EXPECT_FALSE(cache.contains(std::string_view("missing")));
+    EXPECT_THROW(cache.get(std::string_view("missing")), std::out_of_range);
+
+    cache.put("short");
+    EXPECT_EQ(cache.get("short"), 5u);
+
+    // частоты после прозрачных get учитываются так же: вытесняется "short"
+    cache.get(view);
+    cache.put(url(2));
+    EXPECT_TRUE(cache.contains(view));
+    EXPECT_FALSE(cache.contains("short"));
+    EXPECT_EQ(loads, 3u);
+}
+
+TEST_F(StringKeysTest, ArenaReusesReleasedChunks)
+{
+    keys::StringArena arena;
+
+    std::string_view a = arena.intern(url(1));
+    std::string_view b = arena.intern("tiny");
+    EXPECT_EQ(a, url(1));
+    EXPECT_EQ(b, "tiny");
+    EXPECT_EQ(arena.size(), 2u);
+    EXPECT_EQ(arena.liveBytes(), url(1).size() + 4);
+
+    const char* released = a.data();
+    arena.release(a);
+    std::string_view c = arena.intern(url(2));
+    EXPECT_EQ(c.data(), released);
+    EXPECT_EQ(c, url(2));
+
+    std::string long_key(100000, 'x');
+    std::string_view d = arena.intern(long_key);
+    EXPECT_EQ(d, long_key);
+    EXPECT_EQ(arena.intern("").size(), 0u);
+
+    arena.clear();
+    EXPECT_EQ(arena.size(), 0u);
+    EXPECT_EQ(arena.reservedBytes(), 0u);
+}
+
+TEST_F(StringKeysTest, InternedCacheMatchesStringCache)
+{
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int> dist(1, 300);
+
+    lfu::LFUCache<std::string, size_t> reference(50, [](const std::string& key) { return key.size(); });
+    lfu::InternedLFUCache<size_t> interned(50, [](std::string_view key) { return key.size(); });
+
+    for (int i = 0; i < 20000; i++)
+    {
+        const std::string key = url(dist(gen));
+        bool expected = reference.contains(key);
+        ASSERT_EQ(interned.contains(key), expected);
+        if (expected)
+        {
+            ASSERT_EQ(interned.get(key), reference.get(key));
+        }
+        else
+        {
+            ASSERT_EQ(interned.put(key), reference.put(key));
+        }
+    }
+
+    // каждая строка хранится один раз, освобожденные участки используются повторно
+    EXPECT_EQ(interned.arena().size(), interned.size());
+    EXPECT_LE(interned.arena().reservedBytes(), 2 * keys::StringArena::kBlockSize);
+
+    while (!reference.empty())
+    {
+        auto expected = reference.evict();
+        auto victim = interned.evict();
+        EXPECT_EQ(victim.first, expected.first);
+        EXPECT_EQ(victim.second, expected.second);
+    }
+    EXPECT_TRUE(interned.empty());
+    EXPECT_EQ(interned.arena().size(), 0u);
+}
+
+TEST_F(StringKeysTest, FailedLoadReleasesKey)
+{
+    lfu::InternedLFUCache<int> cache(4, [](std::string_view key) -> int
+    {
+        if (key == "bad")
+        {
+            throw std::runtime_error("backend failure");
+        }
+        return 1;
+    });
+
+    cache.put("good");
+    EXPECT_THROW(cache.put("bad"), std::runtime_error);
+    EXPECT_FALSE(cache.contains("bad"));
+    EXPECT_EQ(cache.arena().size(), 1u);
+
+    cache.clear();
+    EXPECT_TRUE(cache.empty());
+    EXPECT_EQ(cache.arena().reservedBytes(), 0u);
+    cache.put("good");
+    EXPECT_EQ(cache.get("good"), 1);
+}
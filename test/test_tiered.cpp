@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <chrono>
+#include "TieredCache.h"
+#include "global.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+class TieredCacheTest : public Test
+{
+protected:
+    void SetUp() override {}
+    
+    void TearDown() override {}
+};
+
+TEST_F(TieredCacheTest, DemotesAndPromotes)
+{
+    int backend_calls = 0;
+    tier::TieredCache<int, int> cache(2, 10, "test_tiered.log", [&](int key)
+    {
+        backend_calls++;
+        return key * 10;
+    });
+    
+    EXPECT_EQ(cache.get(1), 10);
+    EXPECT_EQ(cache.get(2), 20);
+    EXPECT_EQ(cache.get(3), 30);
+    EXPECT_EQ(cache.demotions(), 1);
+    EXPECT_EQ(backend_calls, 3);
+    
+    EXPECT_EQ(cache.get(1), 10);
+    EXPECT_EQ(cache.diskHits(), 1);
+    EXPECT_EQ(backend_calls, 3);
+    EXPECT_FALSE(cache.disk().contains(1));
+    EXPECT_EQ(cache.requests(), 4);
+}
+
+TEST_F(TieredCacheTest, DiskTierLimitAndCompaction)
+{
+    tier::DiskTier<int, long> disk("test_disk_tier.log", 1000);
+    
+    for (int round = 0; round < 200; round++)
+    {
+        for (int key = 0; key < 1000; key++)
+        {
+            disk.put(key, static_cast<long>(round) * 100000 + key);
+        }
+    }
+    
+    EXPECT_EQ(disk.size(), 1000);
+    EXPECT_GT(disk.compactionCount(), 0);
+    EXPECT_LT(disk.logRecords(), 200000);
+    
+    long value = 0;
+    EXPECT_TRUE(disk.take(7, value));
+    EXPECT_EQ(value, 199L * 100000 + 7);
+    EXPECT_FALSE(disk.take(7, value));
+    
+    for (int key = 1000; key < 1500; key++)
+    {
+        disk.put(key, key);
+    }
+    EXPECT_EQ(disk.size(), 1000);
+    EXPECT_FALSE(disk.contains(8));
+    EXPECT_TRUE(disk.contains(999));
+}
+
+TEST_F(TieredCacheTest, ExpiredEntriesAreNotDemoted)
+{
+    uint64_t now = 0;
+    int backend_calls = 0;
+    tier::TieredCache<int, int> cache(2, 10, "test_tiered_ttl.log", [&](int key)
+    {
+        backend_calls++;
+        return key * 10 + backend_calls;
+    });
+    cache.setClock([&now]() { return now; });
+
+    cache.get(1);
+    cache.get(2);
+    cache.setTTL(1, 100ms);
+    cache.setTTL(2, 200ms);
+
+    now = 500;
+    cache.get(3);
+    EXPECT_EQ(cache.demotions(), 0);
+    EXPECT_FALSE(cache.disk().contains(1));
+    EXPECT_FALSE(cache.disk().contains(2));
+
+    // истекший ключ загружается из источника заново, а не поднимается из файла
+    EXPECT_EQ(cache.get(1), 10 + 4);
+    EXPECT_EQ(cache.diskHits(), 0);
+    EXPECT_EQ(backend_calls, 4);
+
+    cache.get(4);
+    EXPECT_EQ(cache.demotions(), 1);
+}
+
+TEST_F(TieredCacheTest, PromotedEntryKeepsTTL)
+{
+    uint64_t now = 0;
+    int backend_calls = 0;
+    tier::TieredCache<int, int> cache(1, 10, "test_tiered_ttl_keep.log", [&](int key)
+    {
+        backend_calls++;
+        return key * 10 + backend_calls;
+    });
+    cache.setClock([&now]() { return now; });
+
+    cache.get(1);
+    cache.setTTL(1, 100ms);
+    cache.get(2);
+    EXPECT_TRUE(cache.disk().contains(1));
+
+    now = 50;
+    EXPECT_EQ(cache.get(1), 11);
+    EXPECT_EQ(cache.diskHits(), 1);
+
+    // поднятый из файла элемент истекает в исходный срок
+    now = 99;
+    EXPECT_EQ(cache.get(1), 11);
+    now = 100;
+    EXPECT_EQ(cache.get(1), 10 + 3);
+    EXPECT_EQ(backend_calls, 3);
+}
+
+TEST_F(TieredCacheTest, EntryExpiredOnDiskIsNotPromoted)
+{
+    uint64_t now = 0;
+    int backend_calls = 0;
+    tier::TieredCache<int, int> cache(1, 10, "test_tiered_ttl_disk.log", [&](int key)
+    {
+        backend_calls++;
+        return key * 10 + backend_calls;
+    });
+    cache.setClock([&now]() { return now; });
+
+    cache.get(1);
+    cache.setTTL(1, 100ms);
+    cache.get(2);
+    EXPECT_EQ(cache.demotions(), 1);
+
+    now = 150;
+    EXPECT_EQ(cache.get(1), 10 + 3);
+    EXPECT_EQ(cache.diskHits(), 0);
+    EXPECT_FALSE(cache.disk().contains(1));
+}
@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "LFUCache.h"
+#include "LRUCache.h"
+#include "OptimalCache.h"
+#include "Timeline.h"
+#include "global.h"
+
+using namespace testing;
+
+class TimelineTest : public Test
+{
+protected:
+    void SetUp() override {}
+    
+    void TearDown() override {}
+};
+
+namespace
+{
+    std::vector<int> randomRequests(size_t count, int pages, unsigned seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<int> dist(1, pages);
+        std::vector<int> requests;
+        for (size_t i = 0; i < count; i++)
+        {
+            requests.push_back(dist(gen));
+        }
+        return requests;
+    }
+
+    template<typename Cache>
+    timeline::Timeline replay(Cache& cache, const std::vector<int>& requests, size_t window)
+    {
+        timeline::Recorder recorder("policy", window);
+        for (int page : requests)
+        {
+            bool hit = true;
+            try
+            {
+                cache.get(page);
+            }
+            catch (const std::out_of_range&)
+            {
+                cache.put(page);
+                hit = false;
+            }
+            recorder.access(hit, cache);
+        }
+        recorder.finish(cache);
+        return recorder.timeline();
+    }
+}
+
+TEST_F(TimelineTest, FrequencyBins)
+{
+    EXPECT_EQ(timeline::frequencyBin(1), 0u);
+    EXPECT_EQ(timeline::frequencyBin(2), 1u);
+    EXPECT_EQ(timeline::frequencyBin(3), 1u);
+    EXPECT_EQ(timeline::frequencyBin(4), 2u);
+    EXPECT_EQ(timeline::frequencyBin(1 << 20), timeline::kFrequencyBins - 1);
+    EXPECT_THROW(timeline::Recorder("policy", 0), std::invalid_argument);
+}
+
+TEST_F(TimelineTest, WindowsMatchExactCounts)
+{
+    const std::vector<int> requests = randomRequests(10500, 200, 3);
+    const size_t capacity = 32;
+
+    lfu::LFUCache<int, int> cache(capacity, slow_get_page_int);
+    timeline::Timeline result = replay(cache, requests, 1000);
+
+    ASSERT_EQ(result.rows(), 11u);
+    EXPECT_EQ(result.end.back(), requests.size());
+    EXPECT_EQ(result.hits[10] + result.misses[10], 500u);
+
+    // эталон: отдельный кэш с подсчетом вытеснений по get/put
+    lfu::LFUCache<int, int> reference(capacity, slow_get_page_int);
+    size_t row = 0;
+    size_t hits = 0;
+    size_t evictions = 0;
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        try
+        {
+            reference.get(requests[i]);
+            hits++;
+        }
+        catch (const std::out_of_range&)
+        {
+            evictions += reference.size() == capacity ? 1 : 0;
+            reference.put(requests[i]);
+        }
+
+        if ((i + 1) % 1000 == 0 || i + 1 == requests.size())
+        {
+            EXPECT_EQ(result.hits[row], hits);
+            EXPECT_EQ(result.evictions[row], evictions);
+            EXPECT_EQ(result.occupancy[row], reference.size());
+            row++;
+            hits = 0;
+            evictions = 0;
+        }
+    }
+}
+
+TEST_F(TimelineTest, FrequencyHistogramCoversCache)
+{
+    const std::vector<int> requests = randomRequests(5000, 100, 5);
+
+    lfu::LFUCache<int, int> cache(20, slow_get_page_int);
+    timeline::Timeline result = replay(cache, requests, 700);
+
+    ASSERT_TRUE(result.hasFrequencies());
+    for (size_t row = 0; row < result.rows(); row++)
+    {
+        uint64_t total = 0;
+        for (const auto& bin : result.frequency_bins)
+        {
+            total += bin[row];
+        }
+        EXPECT_EQ(total, result.occupancy[row]);
+        EXPECT_GE(result.min_frequency[row], 1);
+    }
+
+    lru::LRUCache<int, int> lru(20, slow_get_page_int);
+    timeline::Timeline lru_result = replay(lru, requests, 700);
+    EXPECT_FALSE(lru_result.hasFrequencies());
+    EXPECT_EQ(lru_result.min_frequency.front(), -1);
+}
+
+TEST_F(TimelineTest, OptimalCache)
+{
+    const std::vector<int> requests = randomRequests(3000, 80, 9);
+
+    opt::OptimalCache<int, int> cache(10, slow_get_page_int);
+    cache.preprocessRequests(requests);
+    timeline::Recorder recorder("Optimal", 256);
+    for (int page : requests)
+    {
+        recorder.access(cache.step(page), cache);
+    }
+    recorder.finish(cache);
+
+    uint64_t hits = 0;
+    for (uint64_t value : recorder.timeline().hits)
+    {
+        hits += value;
+    }
+    EXPECT_EQ(hits, cache.getHitCount());
+    EXPECT_EQ(recorder.timeline().occupancy.back(), 10u);
+}
+
+TEST_F(TimelineTest, BinaryRoundTrip)
+{
+    const std::vector<int> requests = randomRequests(4000, 150, 13);
+    lfu::LFUCache<int, int> lfu_cache(16, slow_get_page_int);
+    lru::LRUCache<int, int> lru_cache(16, slow_get_page_int);
+
+    std::vector<timeline::Timeline> written = {replay(lfu_cache, requests, 333), replay(lru_cache, requests, 333)};
+    written[1].policy = "LRU";
+
+    const std::string path = "test_timeline.bin";
+    timeline::write(path, written);
+    std::vector<timeline::Timeline> read = timeline::readBinary(path);
+
+    ASSERT_EQ(read.size(), 2u);
+    for (size_t i = 0; i < read.size(); i++)
+    {
+        EXPECT_EQ(read[i].policy, written[i].policy);
+        EXPECT_EQ(read[i].window, written[i].window);
+        EXPECT_EQ(read[i].end, written[i].end);
+        EXPECT_EQ(read[i].hits, written[i].hits);
+        EXPECT_EQ(read[i].misses, written[i].misses);
+        EXPECT_EQ(read[i].evictions, written[i].evictions);
+        EXPECT_EQ(read[i].occupancy, written[i].occupancy);
+        EXPECT_EQ(read[i].min_frequency, written[i].min_frequency);
+        EXPECT_EQ(read[i].frequency_bins, written[i].frequency_bins);
+    }
+
+    // обрезанный файл
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size() - 8);
+    }
+    EXPECT_THROW(timeline::readBinary(path), StorageException);
+    std::remove(path.c_str());
+}
+
+TEST_F(TimelineTest, CsvHasRowPerWindow)
+{
+    const std::vector<int> requests = randomRequests(2500, 50, 17);
+    lfu::LFUCache<int, int> cache(8, slow_get_page_int);
+
+    const std::string path = "test_timeline.csv";
+    timeline::write(path, {replay(cache, requests, 1000)});
+
+    std::ifstream in(path);
+    std::string header;
+    std::getline(in, header);
+    EXPECT_EQ(header.rfind("policy,end,hit_rate,hits,misses,evictions,occupancy,min_frequency,freq_1,", 0), 0u);
+
+    size_t lines = 0;
+    for (std::string line; std::getline(in, line);)
+    {
+        EXPECT_EQ(line.rfind("policy,", 0), 0u);
+        lines++;
+    }
+    EXPECT_EQ(lines, 3u);
+    std::remove(path.c_str());
+}
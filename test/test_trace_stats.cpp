@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <set>
+#include <map>
+#include <random>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include "TraceFile.h"
+#include "TraceStats.h"
+
+using namespace testing;
+
+class TraceStatsTest : public Test
+{
+protected:
+    void SetUp() override {}
+    
+    void TearDown() override {}
+};
+
+namespace
+{
+    std::vector<int> zipfTrace(size_t n, int pages, double alpha, uint64_t seed)
+    {
+        std::vector<double> weights(pages);
+        for (int i = 0; i < pages; i++)
+        {
+            weights[i] = 1.0 / std::pow(i + 1, alpha);
+        }
+        std::discrete_distribution<int> dist(weights.begin(), weights.end());
+        std::mt19937_64 gen(seed);
+
+        std::vector<int> trace(n);
+        for (int& key : trace)
+        {
+            key = dist(gen);
+        }
+        return trace;
+    }
+}
+
+TEST_F(TraceStatsTest, BinaryAndTextRoundTrip)
+{
+    std::vector<int> requests = {0, -5, 7, 123456789, 7, 0};
+
+    trace::writeTrace("test_trace.bin", requests);
+    trace::writeTrace("test_trace.txt", requests, true);
+
+    trace::TraceReader binary("test_trace.bin");
+    EXPECT_TRUE(binary.binary());
+    EXPECT_EQ(binary.count(), requests.size());
+    EXPECT_EQ(trace::readTrace("test_trace.bin"), requests);
+    EXPECT_EQ(trace::readTrace("test_trace.txt"), requests);
+
+    std::ofstream("test_trace.txt") << "1 2 x 3";
+    EXPECT_THROW(trace::readTrace("test_trace.txt"), StorageException);
+
+    std::remove("test_trace.bin");
+    std::remove("test_trace.txt");
+}
+
+TEST_F(TraceStatsTest, HyperLogLogMergesParts)
+{
+    stats::HyperLogLog<int> first;
+    stats::HyperLogLog<int> second;
+    for (int i = 0; i < 150000; i++)
+    {
+        first.add(i);
+        second.add(i + 50000);
+    }
+    first.merge(second);
+
+    EXPECT_NEAR(first.estimate(), 200000.0, 200000.0 * 4 * first.relativeError());
+
+    stats::HyperLogLog<int> small;
+    for (int i = 0; i < 100; i++)
+    {
+        small.add(i % 37);
+    }
+    EXPECT_NEAR(small.estimate(), 37.0, 2.0);
+}
+
+TEST_F(TraceStatsTest, SpaceSavingFindsHeavyHittersAndZipf)
+{
+    std::vector<int> requests = zipfTrace(400000, 50000, 1.0, 3);
+
+    std::map<int, uint64_t> exact;
+    stats::SpaceSaving<int> left(256);
+    stats::SpaceSaving<int> right(256);
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        exact[requests[i]]++;
+        (i % 2 == 0 ? left : right).add(requests[i]);
+    }
+    left.merge(right);
+
+    auto top = left.top();
+    for (int key = 0; key < 10; key++)
+    {
+        auto it = std::find_if(top.begin(), top.end(), [&](const auto& c) { return c.key == key; });
+        ASSERT_NE(it, top.end()) << "key " << key;
+        EXPECT_GE(it->count, exact[key]);
+        EXPECT_LE(it->count - it->error, exact[key]);
+    }
+
+    std::vector<uint64_t> counts = left.reliableCounts();
+    EXPECT_GE(counts.size(), 16u);
+    EXPECT_NEAR(stats::fitZipf(counts), 1.0, 0.15);
+}
+
+TEST_F(TraceStatsTest, ExactReuseDistancesAndWorkingSet)
+{
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int> dist(0, 40);
+    std::vector<int> requests(3000);
+    for (int& key : requests)
+    {
+        key = dist(gen);
+    }
+
+    stats::ReuseOptions options;
+    options.windows = {1, 10, 100};
+    options.initial_positions = 64;
+    stats::ReuseProfiler<int> profiler(options);
+    for (size_t t = 0; t < requests.size(); t++)
+    {
+        profiler.access(requests[t], t);
+    }
+    EXPECT_GT(profiler.compactions(), 0u);
+
+    std::vector<double> histogram;
+    double cold = 0;
+    std::map<int, size_t> last;
+    std::vector<double> ws_sum(3, 0.0), ws_max(3, 0.0);
+    for (size_t t = 0; t < requests.size(); t++)
+    {
+        auto it = last.find(requests[t]);
+        if (it == last.end())
+        {
+            cold++;
+        }
+        else
+        {
+            std::set<int> between(requests.begin() + it->second + 1, requests.begin() + t);
+            size_t bin = stats::ReuseProfiler<int>::binOf(static_cast<double>(between.size()));
+            histogram.resize(std::max(histogram.size(), bin + 1), 0.0);
+            histogram[bin]++;
+        }
+        last[requests[t]] = t;
+
+        for (size_t w = 0; w < 3; w++)
+        {
+            size_t window = options.windows[w];
+            size_t begin = t + 1 >= window ? t + 1 - window : 0;
+            double size = std::set<int>(requests.begin() + begin, requests.begin() + t + 1).size();
+            ws_sum[w] += size;
+            ws_max[w] = std::max(ws_max[w], size);
+        }
+    }
+
+    EXPECT_EQ(profiler.coldMisses(), cold);
+    ASSERT_EQ(profiler.histogram().size(), histogram.size());
+    for (size_t bin = 0; bin < histogram.size(); bin++)
+    {
+        EXPECT_EQ(profiler.histogram()[bin], histogram[bin]) << "bin " << bin;
+    }
+
+    auto working_sets = profiler.workingSets();
+    for (size_t w = 0; w < 3; w++)
+    {
+        EXPECT_NEAR(working_sets[w].mean, ws_sum[w] / requests.size(), 1e-9);
+        EXPECT_EQ(working_sets[w].max, ws_max[w]);
+    }
+}
+
+TEST_F(TraceStatsTest, BoundedSampleKeepsEstimates)
+{
+    std::vector<int> requests;
+    for (int i = 0; i < 200000; i++)
+    {
+        requests.push_back(i % 20000 < 10000 ? i % 20000 : 1000000 + i);
+    }
+
+    stats::ReuseOptions options;
+    options.max_tracked = 2000;
+    options.windows = {20000};
+    stats::ReuseProfiler<int> profiler(options);
+    for (size_t t = 0; t < requests.size(); t++)
+    {
+        profiler.access(requests[t], t);
+    }
+
+    EXPECT_LE(profiler.trackedKeys(), 2000u);
+    EXPECT_LT(profiler.rate(), 1.0);
+    EXPECT_NEAR(profiler.references(), 200000.0, 200000.0 * 0.2);
+    EXPECT_NEAR(profiler.workingSets()[0].mean, 20000.0, 20000.0 * 0.25);
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include "LFUCache.h"
+#include "TimingWheel.h"
+#include "global.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+class TTLTest : public Test
+{
+protected:
+    void SetUp() override {}
+    
+    void TearDown() override {}
+};
+
+namespace
+{
+    struct RecordingListener : lfu::EvictionListener<int, int>
+    {
+        std::vector<std::pair<int, bool>> evicted;
+
+        void onEvict(const int& key, const int&, bool dirty) override
+        {
+            evicted.emplace_back(key, dirty);
+        }
+    };
+}
+
+TEST_F(TTLTest, WheelFiresExactlyAtDeadline)
+{
+    timer::TimingWheel<int> wheel(1000);
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> deadlines;
+
+    // сроки на всех уровнях колеса и за его пределами
+    for (int i = 0; i < 2000; i++)
+    {
+        uint64_t delay = 1 + rng() % (uint64_t(1) << (6 * (1 + i % 5)));
+        deadlines.push_back(1000 + delay);
+        wheel.schedule(i, deadlines.back());
+    }
+
+    // таймер должен сработать на том шаге, который впервые перешел его срок
+    std::vector<uint64_t> fired(deadlines.size(), 0);
+    std::vector<uint64_t> fired_after(deadlines.size(), 0);
+    uint64_t now = 1000;
+    while (!wheel.empty())
+    {
+        uint64_t previous = now;
+        now += 1 + rng() % (uint64_t(1) << (rng() % 18));
+        wheel.advance(now, [&](const int& key) {
+            fired[key] = now;
+            fired_after[key] = previous;
+        });
+    }
+
+    for (size_t i = 0; i < deadlines.size(); i++)
+    {
+        EXPECT_GE(fired[i], deadlines[i]) << "timer " << i;
+        EXPECT_LT(fired_after[i], deadlines[i]) << "timer " << i;
+    }
+}
+
+TEST_F(TTLTest, WheelCancel)
+{
+    timer::TimingWheel<int> wheel;
+    auto first = wheel.schedule(1, 10);
+    wheel.schedule(2, 10);
+    wheel.schedule(3, 100000);
+    wheel.cancel(first);
+
+    std::vector<int> fired;
+    EXPECT_EQ(wheel.advance(50, [&](const int& key) { fired.push_back(key); }), 1u);
+    EXPECT_EQ(fired, std::vector<int>({2}));
+    EXPECT_EQ(wheel.size(), 1u);
+}
+
+TEST_F(TTLTest, WheelFiresOnLevelBoundary)
+{
+    // срок 64 попадает на первый уровень и разворачивается ровно в тик срабатывания
+    timer::TimingWheel<int> wheel;
+    wheel.schedule(1, 64);
+    wheel.schedule(2, 4096);
+
+    std::vector<int> fired;
+    EXPECT_EQ(wheel.advance(63, [&](const int& key) { fired.push_back(key); }), 0u);
+    EXPECT_EQ(wheel.advance(64, [&](const int& key) { fired.push_back(key); }), 1u);
+    EXPECT_EQ(wheel.advance(4095, [&](const int& key) { fired.push_back(key); }), 0u);
+    EXPECT_EQ(wheel.advance(4096, [&](const int& key) { fired.push_back(key); }), 1u);
+    EXPECT_EQ(fired, std::vector<int>({1, 2}));
+}
+
+TEST_F(TTLTest, EvictionAtLevelBoundaryTakesExpiredEntry)
+{
+    uint64_t now = 0;
+    lfu::LFUCache<int, int> cache(2, slow_get_page_int);
+    cache.setClock([&]() { return now; });
+
+    cache.update(1, 10, 64ms);
+    cache.put(2);
+    cache.get(1);
+
+    now = 64;
+    auto victim = cache.evict();
+    EXPECT_EQ(victim.first, 1);
+    EXPECT_EQ(cache.expiredCount(), 1u);
+    EXPECT_NO_THROW(cache.get(2));
+}
+
+TEST_F(TTLTest, ExpiredEntryIsMissOnGet)
+{
+    uint64_t now = 0;
+    lfu::LFUCache<int, int> cache(4, slow_get_page_int);
+    cache.setClock([&]() { return now; });
+
+    cache.put(1, 100ms);
+    cache.put(2);
+    now = 99;
+    EXPECT_EQ(cache.get(1), 1);
+    now = 100;
+    EXPECT_THROW(cache.get(1), std::out_of_range);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.get(2), 2);
+    EXPECT_EQ(cache.expiredCount(), 1u);
+}
+
+TEST_F(TTLTest, PutReclaimsExpiredEntries)
+{
+    uint64_t now = 0;
+    lfu::LFUCache<int, int> cache(8, slow_get_page_int);
+    cache.setClock([&]() { return now; });
+
+    for (int i = 0; i < 5; i++)
+    {
+        cache.put(i, std::chrono::milliseconds(10 * (i + 1)));
+    }
+
+    now = 30;
+    cache.put(100);
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_EQ(cache.expiredCount(), 3u);
+    EXPECT_NO_THROW(cache.get(3));
+}
+
+TEST_F(TTLTest, EvictionPrefersExpiredEntries)
+{
+    uint64_t now = 0;
+    RecordingListener listener;
+    lfu::LFUCache<int, int> cache(3, slow_get_page_int);
+    cache.setClock([&]() { return now; });
+    cache.setEvictionListener(&listener);
+
+    cache.put(1);
+    cache.update(2, 20, 50ms);
+    cache.put(3);
+    for (int i = 0; i < 5; i++)
+    {
+        cache.get(2);
+    }
+
+    // элемент 2 самый частый, но его срок истек - он уходит раньше элемента 1
+    now = 60;
+    auto victim = cache.evict();
+    EXPECT_EQ(victim.first, 2);
+    EXPECT_EQ(victim.second, 20);
+    ASSERT_EQ(listener.evicted.size(), 1u);
+    EXPECT_TRUE(listener.evicted[0].second);
+    EXPECT_NO_THROW(cache.get(1));
+}
+
+TEST_F(TTLTest, SetTTLAndPersist)
+{
+    uint64_t now = 0;
+    lfu::LFUCache<int, int> cache(4, slow_get_page_int);
+    cache.setClock([&]() { return now; });
+
+    cache.put(1, 10ms);
+    cache.setTTL(1, 0ms);
+    cache.put(2);
+    cache.setTTL(2, 5ms);
+    now = 1000000;
+    EXPECT_NO_THROW(cache.get(1));
+    EXPECT_THROW(cache.get(2), std::out_of_range);
+    EXPECT_THROW(cache.setTTL(2, 5ms), std::out_of_range);
+}
+
+TEST_F(TTLTest, SnapshotKeepsRemainingTTL)
+{
+    const std::string path = "test_ttl.snapshot";
+    uint64_t now = 1000;
+    lfu::LFUCache<int, int> cache(4, slow_get_page_int);
+    cache.setClock([&]() { return now; });
+    cache.put(1, 100ms);
+    cache.put(2);
+    now = 1040;
+    cache.saveSnapshot(path);
+
+    uint64_t later = 50000;
+    lfu::LFUCache<int, int> restored(4, slow_get_page_int);
+    restored.setClock([&]() { return later; });
+    restored.loadSnapshot(path);
+    std::remove(path.c_str());
+
+    later += 59;
+    EXPECT_NO_THROW(restored.get(1));
+    later += 1;
+    EXPECT_THROW(restored.get(1), std::out_of_range);
+    EXPECT_NO_THROW(restored.get(2));
+}
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <future>
+#include "LFUCache.h"
+#include "WriteBackBuffer.h"
+#include "global.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+/**
+ * @brief Локальный источник, который считает обращения на запись
+ */
+class FakeBackend
+{
+private:
+    std::mutex mutex_;
+    std::map<int, int> data_;
+    size_t write_calls_ = 0;
+    size_t written_entries_ = 0;
+
+public:
+    void write(const std::vector<std::pair<int, int>>& batch)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        write_calls_++;
+        written_entries_ += batch.size();
+        for (const auto& [key, value] : batch)
+        {
+            data_[key] = value;
+        }
+    }
+
+    int read(int key)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = data_.find(key);
+        return it == data_.end() ? key : it->second;
+    }
+
+    size_t writeCalls()     { std::lock_guard<std::mutex> lock(mutex_); return write_calls_; }
+    size_t writtenEntries() { std::lock_guard<std::mutex> lock(mutex_); return written_entries_; }
+};
+
+class WriteBackTest : public Test
+{
+protected:
+    FakeBackend backend;
+
+    void SetUp() override {}
+    
+    void TearDown() override {}
+};
+
+TEST_F(WriteBackTest, OnlyDirtyVictimsAreWrittenInBatches)
+{
+    lfu::WriteBackBuffer<int, int> buffer([this](const auto& batch) { backend.write(batch); }, 10, 10s);
+    lfu::LFUCache<int, int> cache(4, [this](int key) { return backend.read(key); });
+    cache.setEvictionListener(&buffer);
+    
+    for (int key = 0; key < 100; key++)
+    {
+        cache.put(key);
+        if (key % 2 == 0)
+        {
+            cache.getMutable(key) += 1000;
+        }
+    }
+    
+    cache.clear();
+    buffer.flush();
+    
+    // изменена половина из 100 элементов, остальные не пишутся
+    EXPECT_EQ(backend.writtenEntries(), 50);
+    EXPECT_EQ(backend.writeCalls(), 5);
+    EXPECT_EQ(backend.read(10), 1010);
+    EXPECT_EQ(backend.read(11), 11);
+}
+
+TEST_F(WriteBackTest, DeadlineFlushesPartialBatch)
+{
+    lfu::WriteBackBuffer<int, int> buffer([this](const auto& batch) { backend.write(batch); }, 1000, 20ms);
+    lfu::LFUCache<int, int> cache(1, slow_get_page_int);
+    cache.setEvictionListener(&buffer);
+    
+    cache.update(1, 10);
+    cache.update(2, 20);
+    cache.update(3, 30);
+    
+    for (int i = 0; i < 200 && backend.writtenEntries() < 2; i++)
+    {
+        std::this_thread::sleep_for(5ms);
+    }
+    
+    EXPECT_EQ(backend.writtenEntries(), 2);
+    EXPECT_EQ(backend.writeCalls(), 1);
+    EXPECT_TRUE(cache.isDirty(3));
+}
+
+TEST_F(WriteBackTest, RepeatedEvictionsAreCoalesced)
+{
+    lfu::WriteBackBuffer<int, int> buffer([this](const auto& batch) { backend.write(batch); }, 100, 10s);
+    lfu::LFUCache<int, int> cache(1, slow_get_page_int);
+    cache.setEvictionListener(&buffer);
+    
+    for (int round = 0; round < 5; round++)
+    {
+        cache.update(7, round);
+        cache.put(8);
+    }
+    cache.clear();
+    buffer.flush();
+    
+    EXPECT_EQ(backend.writeCalls(), 1);
+    EXPECT_EQ(backend.writtenEntries(), 1);
+    EXPECT_EQ(buffer.coalescedCount(), 4);
+    EXPECT_EQ(backend.read(7), 4);
+}
+
+TEST_F(WriteBackTest, DirtyEntryIsNotReloaded)
+{
+    lfu::LFUCache<int, int> cache(2, slow_get_page_int);
+    
+    cache.put(1);
+    cache.update(1, 42);
+    EXPECT_EQ(cache.put(1), 42);
+    EXPECT_TRUE(cache.isDirty(1));
+    EXPECT_THROW(cache.markDirty(2), std::out_of_range);
+}
+
+TEST_F(WriteBackTest, FlushWaitsForBatchInFlight)
+{
+    std::atomic<bool> started{false};
+    lfu::WriteBackBuffer<int, int> buffer([&](const auto& batch)
+    {
+        started = true;
+        std::this_thread::sleep_for(100ms);
+        backend.write(batch);
+    }, 1, 10s);
+
+    buffer.onEvict(1, 11, true);
+    while (!started)
+    {
+        std::this_thread::yield();
+    }
+
+    // буфер уже пуст, но пачка еще пишется
+    EXPECT_EQ(buffer.pendingCount(), 0);
+    buffer.flush();
+    EXPECT_EQ(backend.writtenEntries(), 1);
+    EXPECT_EQ(backend.read(1), 11);
+}
+
+TEST_F(WriteBackTest, EvictedDirtyKeyIsReadBeforeWrite)
+{
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<bool> started{false};
+
+    lfu::WriteBackBuffer<int, int> buffer([&](const auto& batch)
+    {
+        started = true;
+        released.wait();
+        backend.write(batch);
+    }, 1, 10s);
+
+    lfu::LFUCache<int, int> cache(1, [this](int key) { return backend.read(key); });
+    cache.setEvictionListener(&buffer);
+
+    cache.put(1);
+    cache.update(1, 42);
+    cache.put(2);
+    while (!started)
+    {
+        std::this_thread::yield();
+    }
+
+    // ключ 1 в записываемой пачке, ключ 2 ждет в буфере за ней
+    cache.update(2, 43);
+    EXPECT_EQ(cache.put(1), 42);
+    EXPECT_EQ(buffer.pendingCount(), 1);
+    EXPECT_EQ(cache.put(2), 43);
+    EXPECT_EQ(backend.read(1), 1);
+
+    release.set_value();
+    buffer.flush();
+    EXPECT_EQ(backend.read(1), 42);
+    EXPECT_EQ(backend.read(2), 43);
+    EXPECT_FALSE(buffer.lookup(1).has_value());
+}
+
+TEST_F(WriteBackTest, LeftoverAfterFullBatchKeepsItsOwnDeadline)
+{
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<bool> started{false};
+
+    lfu::WriteBackBuffer<int, int> buffer([&](const auto& batch)
+    {
+        started = true;
+        released.wait();
+        backend.write(batch);
+    }, 2, 400ms);
+
+    // первая пачка занимает поток, пока буфер набирается
+    buffer.onEvict(100, 1, true);
+    buffer.onEvict(101, 1, true);
+    while (!started)
+    {
+        std::this_thread::yield();
+    }
+
+    buffer.onEvict(1, 1, true);
+    std::this_thread::sleep_for(300ms);
+    buffer.onEvict(2, 2, true);
+    buffer.onEvict(3, 3, true);
+    release.set_value();
+
+    // пачка из 1 и 2 пишется сразу, а 3 ждет своего срока, а не срока ключа 1
+    std::this_thread::sleep_for(200ms);
+    EXPECT_EQ(buffer.pendingCount(), 1);
+    EXPECT_EQ(backend.writtenEntries(), 4);
+
+    buffer.flush();
+    EXPECT_EQ(backend.writtenEntries(), 5);
+}